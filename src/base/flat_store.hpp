@@ -0,0 +1,250 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2024, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QList>
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace base {
+
+// An int-keyed container that keeps its values in fixed-size chunks of contiguous memory, and
+// finds them through an open-addressing hash table. Pointers to values stay valid until their
+// key is erased or the store is cleared, so callers can keep `const T*` handles across updates.
+template <typename T, size_t ChunkSize = 256>
+class FlatStore final {
+public:
+  class const_iterator;
+
+  const T* find(const int key) const {
+    const auto slot = findSlot(key);
+    return slot != kNoSlot ? &at(slot) : nullptr;
+  }
+
+  T* find(const int key) {
+    const auto slot = findSlot(key);
+    return slot != kNoSlot ? &at(slot) : nullptr;
+  }
+
+  bool contains(const int key) const {
+    return findSlot(key) != kNoSlot;
+  }
+
+  // Returns the value for `key`, inserting a default-constructed one if it doesn't exist
+  T& operator[](const int key) {
+    if (const auto slot = findSlot(key); slot != kNoSlot) return at(slot);
+    return at(insert(key));
+  }
+
+  bool erase(const int key) {
+    if (buckets_.empty()) return false;
+
+    auto i = bucketIndex(key);
+    while (buckets_[i].key != key) {
+      if (buckets_[i].key == kEmptyKey) return false;
+      i = (i + 1) & mask();
+    }
+
+    const auto slot = buckets_[i].slot;
+    at(slot) = T{};  // release the memory held by the value
+    slot_keys_[slot] = kEmptyKey;
+    free_slots_.push_back(slot);
+    --size_;
+
+    // Backward-shift deletion, so that lookups never have to step over tombstones
+    for (auto j = (i + 1) & mask(); buckets_[j].key != kEmptyKey; j = (j + 1) & mask()) {
+      const auto home = bucketIndex(buckets_[j].key);
+      if (((j - home) & mask()) >= ((j - i) & mask())) {
+        buckets_[i] = buckets_[j];
+        i = j;
+      }
+    }
+    buckets_[i] = Bucket{};
+
+    return true;
+  }
+
+  void clear() {
+    chunks_.clear();
+    slot_keys_.clear();
+    free_slots_.clear();
+    buckets_.clear();
+    size_ = 0;
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  QList<int> keys() const {
+    QList<int> keys;
+    keys.reserve(size_);
+    for (const auto key : slot_keys_) {
+      if (key != kEmptyKey) keys.push_back(key);
+    }
+    return keys;
+  }
+
+  const_iterator begin() const {
+    return const_iterator{this, 0};
+  }
+
+  const_iterator end() const {
+    return const_iterator{this, slot_keys_.size()};
+  }
+
+  class const_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    const_iterator() = default;
+
+    reference operator*() const {
+      return store_->at(slot_);
+    }
+
+    pointer operator->() const {
+      return &store_->at(slot_);
+    }
+
+    const_iterator& operator++() {
+      ++slot_;
+      skipFreeSlots();
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      auto it = *this;
+      ++(*this);
+      return it;
+    }
+
+    bool operator==(const const_iterator&) const = default;
+
+  private:
+    friend class FlatStore;
+
+    const_iterator(const FlatStore* store, size_t slot) : store_{store}, slot_{slot} {
+      skipFreeSlots();
+    }
+
+    void skipFreeSlots() {
+      while (slot_ < store_->slot_keys_.size() && store_->slot_keys_[slot_] == kEmptyKey) {
+        ++slot_;
+      }
+    }
+
+    const FlatStore* store_ = nullptr;
+    size_t slot_ = 0;
+  };
+
+private:
+  static constexpr int kEmptyKey = std::numeric_limits<int>::min();
+  static constexpr uint32_t kNoSlot = std::numeric_limits<uint32_t>::max();
+
+  struct Bucket {
+    int key = kEmptyKey;
+    uint32_t slot = kNoSlot;
+  };
+
+  size_t mask() const {
+    return buckets_.size() - 1;
+  }
+
+  // Fibonacci hashing spreads sequential ids across the table
+  size_t bucketIndex(const int key) const {
+    const auto hash = static_cast<uint32_t>(key) * 0x9E3779B9u;
+    return hash >> (32 - std::bit_width(mask()));
+  }
+
+  uint32_t findSlot(const int key) const {
+    if (buckets_.empty()) return kNoSlot;
+
+    for (auto i = bucketIndex(key);; i = (i + 1) & mask()) {
+      if (buckets_[i].key == key) return buckets_[i].slot;
+      if (buckets_[i].key == kEmptyKey) return kNoSlot;
+    }
+  }
+
+  uint32_t insert(const int key) {
+    // Keep the load factor at or below 1/2
+    if ((size_ + 1) * 2 > buckets_.size()) rehash(std::max<size_t>(16, buckets_.size() * 2));
+
+    uint32_t slot;
+    if (!free_slots_.empty()) {
+      slot = free_slots_.back();
+      free_slots_.pop_back();
+      slot_keys_[slot] = key;
+    } else {
+      slot = static_cast<uint32_t>(slot_keys_.size());
+      if (slot % ChunkSize == 0) chunks_.push_back(std::make_unique<T[]>(ChunkSize));
+      slot_keys_.push_back(key);
+    }
+
+    auto i = bucketIndex(key);
+    while (buckets_[i].key != kEmptyKey) i = (i + 1) & mask();
+    buckets_[i] = Bucket{key, slot};
+
+    ++size_;
+
+    return slot;
+  }
+
+  void rehash(const size_t bucketCount) {
+    std::vector<Bucket> buckets(bucketCount);
+    std::swap(buckets_, buckets);
+
+    for (const auto& bucket : buckets) {
+      if (bucket.key == kEmptyKey) continue;
+      auto i = bucketIndex(bucket.key);
+      while (buckets_[i].key != kEmptyKey) i = (i + 1) & mask();
+      buckets_[i] = bucket;
+    }
+  }
+
+  const T& at(const uint32_t slot) const {
+    return chunks_[slot / ChunkSize][slot % ChunkSize];
+  }
+
+  T& at(const uint32_t slot) {
+    return chunks_[slot / ChunkSize][slot % ChunkSize];
+  }
+
+  std::vector<std::unique_ptr<T[]>> chunks_;
+  std::vector<int> slot_keys_;
+  std::vector<uint32_t> free_slots_;
+  std::vector<Bucket> buckets_;
+  size_t size_ = 0;
+};
+
+}  // namespace base
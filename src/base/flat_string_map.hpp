@@ -0,0 +1,187 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2024, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace base {
+
+// A string-keyed map that keeps its entries in one contiguous array, and finds them through an
+// open-addressing hash table. Lookups take a `std::string_view`, so callers don't have to build a
+// temporary string, and each bucket keeps the hash of its key, so that a probe only compares the
+// strings when the hashes are equal. Erasing an entry moves the last entry into its place, which
+// invalidates references to that entry.
+template <typename T>
+class FlatStringMap final {
+public:
+  const T* find(const std::string_view key) const {
+    const auto index = findIndex(key, hash(key));
+    return index != kNoIndex ? &entries_[index].value : nullptr;
+  }
+
+  T* find(const std::string_view key) {
+    const auto index = findIndex(key, hash(key));
+    return index != kNoIndex ? &entries_[index].value : nullptr;
+  }
+
+  bool contains(const std::string_view key) const {
+    return findIndex(key, hash(key)) != kNoIndex;
+  }
+
+  // Returns the value for `key`, inserting a default-constructed one if it doesn't exist
+  T& operator[](const std::string_view key) {
+    const auto h = hash(key);
+    if (const auto index = findIndex(key, h); index != kNoIndex) return entries_[index].value;
+    return entries_[insert(key, h)].value;
+  }
+
+  bool erase(const std::string_view key) {
+    if (buckets_.empty()) return false;
+
+    const auto h = hash(key);
+    auto i = bucketIndex(h);
+    while (!matches(buckets_[i], key, h)) {
+      if (buckets_[i].index == kNoIndex) return false;
+      i = (i + 1) & mask();
+    }
+
+    // Move the last entry into the erased one, and point its bucket to the new position
+    const auto index = buckets_[i].index;
+    const auto last = static_cast<uint32_t>(entries_.size() - 1);
+    if (index != last) {
+      buckets_[findBucket(last)].index = index;
+      entries_[index] = std::move(entries_[last]);
+    }
+    entries_.pop_back();
+
+    // Backward-shift deletion, so that lookups never have to step over tombstones
+    for (auto j = (i + 1) & mask(); buckets_[j].index != kNoIndex; j = (j + 1) & mask()) {
+      const auto home = bucketIndex(buckets_[j].hash);
+      if (((j - home) & mask()) >= ((j - i) & mask())) {
+        buckets_[i] = buckets_[j];
+        i = j;
+      }
+    }
+    buckets_[i] = Bucket{};
+
+    return true;
+  }
+
+  void clear() {
+    entries_.clear();
+    buckets_.clear();
+  }
+
+  bool empty() const {
+    return entries_.empty();
+  }
+
+  size_t size() const {
+    return entries_.size();
+  }
+
+private:
+  static constexpr uint32_t kNoIndex = std::numeric_limits<uint32_t>::max();
+
+  struct Entry {
+    std::string key;
+    T value{};
+  };
+
+  struct Bucket {
+    uint32_t hash = 0;
+    uint32_t index = kNoIndex;
+  };
+
+  static uint32_t hash(const std::string_view key) {
+    const auto h = static_cast<uint64_t>(std::hash<std::string_view>{}(key));
+    return static_cast<uint32_t>(h ^ (h >> 32));
+  }
+
+  size_t mask() const {
+    return buckets_.size() - 1;
+  }
+
+  // Fibonacci hashing spreads the hash across the table
+  size_t bucketIndex(const uint32_t hash) const {
+    return (hash * 0x9E3779B9u) >> (32 - std::bit_width(mask()));
+  }
+
+  bool matches(const Bucket& bucket, const std::string_view key, const uint32_t hash) const {
+    return bucket.index != kNoIndex && bucket.hash == hash && entries_[bucket.index].key == key;
+  }
+
+  uint32_t findIndex(const std::string_view key, const uint32_t hash) const {
+    if (buckets_.empty()) return kNoIndex;
+
+    for (auto i = bucketIndex(hash);; i = (i + 1) & mask()) {
+      if (buckets_[i].index == kNoIndex) return kNoIndex;
+      if (matches(buckets_[i], key, hash)) return buckets_[i].index;
+    }
+  }
+
+  size_t findBucket(const uint32_t index) const {
+    const auto h = hash(entries_[index].key);
+    auto i = bucketIndex(h);
+    while (buckets_[i].index != index) i = (i + 1) & mask();
+    return i;
+  }
+
+  uint32_t insert(const std::string_view key, const uint32_t hash) {
+    // Keep the load factor at or below 1/2
+    if ((entries_.size() + 1) * 2 > buckets_.size()) {
+      rehash(std::max<size_t>(16, buckets_.size() * 2));
+    }
+
+    const auto index = static_cast<uint32_t>(entries_.size());
+    entries_.emplace_back(std::string{key});
+
+    auto i = bucketIndex(hash);
+    while (buckets_[i].index != kNoIndex) i = (i + 1) & mask();
+    buckets_[i] = Bucket{hash, index};
+
+    return index;
+  }
+
+  void rehash(const size_t bucketCount) {
+    std::vector<Bucket> buckets(bucketCount);
+    std::swap(buckets_, buckets);
+
+    for (const auto& bucket : buckets) {
+      if (bucket.index == kNoIndex) continue;
+      auto i = bucketIndex(bucket.hash);
+      while (buckets_[i].index != kNoIndex) i = (i + 1) & mask();
+      buckets_[i] = bucket;
+    }
+  }
+
+  std::vector<Entry> entries_;
+  std::vector<Bucket> buckets_;
+};
+
+}  // namespace base
@@ -0,0 +1,82 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2024, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace base {
+
+// A fixed-capacity map that evicts the least recently used value when it's full
+template <typename Key, typename Value>
+class LruCache final {
+public:
+  explicit LruCache(const size_t capacity) : capacity_{capacity} {}
+
+  // Marks the value as the most recently used one
+  const Value* find(const Key& key) {
+    const auto it = index_.find(key);
+    if (it == index_.end()) return nullptr;
+    values_.splice(values_.begin(), values_, it->second);
+    return &it->second->second;
+  }
+
+  void insert(const Key& key, Value value) {
+    if (const auto it = index_.find(key); it != index_.end()) {
+      it->second->second = std::move(value);
+      values_.splice(values_.begin(), values_, it->second);
+      return;
+    }
+
+    if (values_.size() == capacity_) {
+      index_.erase(values_.back().first);
+      values_.pop_back();
+    }
+
+    values_.emplace_front(key, std::move(value));
+    index_.emplace(key, values_.begin());
+  }
+
+  void erase(const Key& key) {
+    if (const auto it = index_.find(key); it != index_.end()) {
+      values_.erase(it->second);
+      index_.erase(it);
+    }
+  }
+
+  void clear() {
+    values_.clear();
+    index_.clear();
+  }
+
+  size_t size() const {
+    return values_.size();
+  }
+
+private:
+  using list_t = std::list<std::pair<Key, Value>>;
+
+  size_t capacity_;
+  list_t values_;
+  std::unordered_map<Key, typename list_t::iterator> index_;
+};
+
+}  // namespace base
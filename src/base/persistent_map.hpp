@@ -0,0 +1,193 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2024, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <vector>
+
+namespace base {
+
+// An immutable map of values keyed by an int member (`Key`). Values are spread over a fixed
+// number of chunks, which are shared between a map and the maps that are derived from it, so
+// that deriving a new version only copies the chunks that actually change. Maps can be read from
+// any number of threads at once.
+template <typename T, auto Key, size_t ChunkCount = 256>
+  requires(std::has_single_bit(ChunkCount))
+class PersistentMap final {
+public:
+  class const_iterator;
+
+  const T* find(const int key) const {
+    const auto& chunk = chunks_[chunkIndex(key)];
+    if (!chunk) return nullptr;
+    const auto it = std::ranges::lower_bound(*chunk, key, {}, keyOf);
+    return it != chunk->end() && keyOf(*it) == key ? it->get() : nullptr;
+  }
+
+  bool contains(const int key) const {
+    return find(key) != nullptr;
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  // Returns a new map in which `values` are added or replaced
+  template <std::ranges::input_range R>
+  [[nodiscard]] PersistentMap with(R&& values) const {
+    PersistentMap map{*this};
+    std::bitset<ChunkCount> copied;
+
+    for (const T& value : values) {
+      const int key = std::invoke(Key, value);
+      auto& chunk = map.ownChunk(chunkIndex(key), copied);
+      const auto it = std::ranges::lower_bound(chunk, key, {}, keyOf);
+      auto ptr = std::make_shared<const T>(value);
+      if (it != chunk.end() && keyOf(*it) == key) {
+        *it = std::move(ptr);
+      } else {
+        chunk.insert(it, std::move(ptr));
+        ++map.size_;
+      }
+    }
+
+    return map;
+  }
+
+  // Returns a new map in which `keys` are removed
+  template <std::ranges::input_range R>
+  [[nodiscard]] PersistentMap without(R&& keys) const {
+    PersistentMap map{*this};
+    std::bitset<ChunkCount> copied;
+
+    for (const int key : keys) {
+      if (!contains(key)) continue;
+      auto& chunk = map.ownChunk(chunkIndex(key), copied);
+      const auto it = std::ranges::lower_bound(chunk, key, {}, keyOf);
+      if (it != chunk.end() && keyOf(*it) == key) {
+        chunk.erase(it);
+        --map.size_;
+      }
+    }
+
+    return map;
+  }
+
+  const_iterator begin() const {
+    return const_iterator{this, 0, 0};
+  }
+
+  const_iterator end() const {
+    return const_iterator{this, ChunkCount, 0};
+  }
+
+  class const_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    const_iterator() = default;
+
+    reference operator*() const {
+      return *(*map_->chunks_[chunk_])[index_];
+    }
+
+    pointer operator->() const {
+      return (*map_->chunks_[chunk_])[index_].get();
+    }
+
+    const_iterator& operator++() {
+      ++index_;
+      skipEmptyChunks();
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      auto it = *this;
+      ++(*this);
+      return it;
+    }
+
+    bool operator==(const const_iterator&) const = default;
+
+  private:
+    friend class PersistentMap;
+
+    const_iterator(const PersistentMap* map, size_t chunk, size_t index)
+        : map_{map}, chunk_{chunk}, index_{index} {
+      skipEmptyChunks();
+    }
+
+    void skipEmptyChunks() {
+      while (chunk_ < ChunkCount &&
+             (!map_->chunks_[chunk_] || index_ >= map_->chunks_[chunk_]->size())) {
+        ++chunk_;
+        index_ = 0;
+      }
+    }
+
+    const PersistentMap* map_ = nullptr;
+    size_t chunk_ = 0;
+    size_t index_ = 0;
+  };
+
+private:
+  using chunk_t = std::vector<std::shared_ptr<const T>>;
+
+  static int keyOf(const std::shared_ptr<const T>& value) {
+    return std::invoke(Key, *value);
+  }
+
+  static size_t chunkIndex(const int key) {
+    if constexpr (ChunkCount == 1) return 0;
+    const auto hash = static_cast<uint32_t>(key) * 0x9E3779B9u;
+    return hash >> (32 - std::bit_width(ChunkCount - 1));
+  }
+
+  // Chunks that are shared with other maps are copied before they are first modified
+  chunk_t& ownChunk(const size_t index, std::bitset<ChunkCount>& copied) {
+    if (!copied[index]) {
+      chunks_[index] = chunks_[index] ? std::make_shared<chunk_t>(*chunks_[index])
+                                      : std::make_shared<chunk_t>();
+      copied[index] = true;
+    }
+    return *chunks_[index];
+  }
+
+  std::array<std::shared_ptr<chunk_t>, ChunkCount> chunks_;
+  size_t size_ = 0;
+};
+
+}  // namespace base
@@ -0,0 +1,112 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2024, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "sql.hpp"
+
+#include <QSqlError>
+
+#include "base/log.hpp"
+
+namespace base {
+
+SqlStatementCache::SqlStatementCache(loader_t loader) : loader_{std::move(loader)} {}
+
+void SqlStatementCache::setDatabase(const QSqlDatabase& db) {
+  clear();
+  db_ = db;
+}
+
+QSqlQuery* SqlStatementCache::get(const QString& name) {
+  if (const auto it = queries_.find(name); it != queries_.end()) {
+    ++stats_.hits;
+    return &it->second;
+  }
+
+  return prepare(name, loader_(name));
+}
+
+QSqlQuery* SqlStatementCache::get(const QString& name, const QString& text) {
+  if (const auto it = queries_.find(name); it != queries_.end()) {
+    ++stats_.hits;
+    return &it->second;
+  }
+
+  return prepare(name, text);
+}
+
+void SqlStatementCache::clear() {
+  // Prepared statements must be finalized before their connection is closed.
+  queries_.clear();
+}
+
+const SqlStatementCache::Stats& SqlStatementCache::stats() const {
+  return stats_;
+}
+
+QSqlQuery* SqlStatementCache::prepare(const QString& name, const QString& text) {
+  ++stats_.misses;
+
+  QSqlQuery q{db_};
+  if (!q.prepare(text)) {
+    LOGE("{}: {}", name.toStdString(), q.lastError().text().toStdString());
+    return nullptr;
+  }
+
+  return &queries_.emplace(name, std::move(q)).first->second;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QStringList splitSqlStatements(const QString& script) {
+  QStringList statements;
+  QString statement;
+
+  bool inQuotes = false;
+  bool inComment = false;
+
+  for (const auto c : script) {
+    if (inComment) {
+      if (c == u'\n') inComment = false;
+      continue;
+    }
+
+    if (c == u'\'') {
+      inQuotes = !inQuotes;
+    } else if (!inQuotes && c == u'-' && statement.endsWith(u'-')) {
+      statement.chop(1);
+      inComment = true;
+      continue;
+    } else if (!inQuotes && c == u';') {
+      if (const auto trimmed = statement.trimmed(); !trimmed.isEmpty()) {
+        statements.push_back(trimmed);
+      }
+      statement.clear();
+      continue;
+    }
+
+    statement.push_back(c);
+  }
+
+  if (const auto trimmed = statement.trimmed(); !trimmed.isEmpty()) {
+    statements.push_back(trimmed);
+  }
+
+  return statements;
+}
+
+}  // namespace base
@@ -0,0 +1,63 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2024, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+#include <QStringList>
+#include <functional>
+#include <unordered_map>
+
+namespace base {
+
+// Keeps prepared statements alive for a single connection, so that each statement is parsed by
+// SQLite only once. Statements are keyed by name, and their text is provided by `loader`.
+class SqlStatementCache final {
+public:
+  using loader_t = std::function<QString(const QString& name)>;
+
+  struct Stats {
+    int hits = 0;
+    int misses = 0;
+  };
+
+  explicit SqlStatementCache(loader_t loader);
+
+  void setDatabase(const QSqlDatabase& db);
+
+  QSqlQuery* get(const QString& name);
+  QSqlQuery* get(const QString& name, const QString& text);
+  void clear();
+
+  const Stats& stats() const;
+
+private:
+  QSqlQuery* prepare(const QString& name, const QString& text);
+
+  QSqlDatabase db_;
+  loader_t loader_;
+  std::unordered_map<QString, QSqlQuery> queries_;
+  Stats stats_;
+};
+
+// Splits a script into individual statements, as `QSqlQuery::exec` only runs the first one.
+QStringList splitSqlStatements(const QString& script);
+
+}  // namespace base
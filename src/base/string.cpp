@@ -22,19 +22,21 @@
 #include <nstd/string.hpp>
 #include <ranges>
 
-namespace {
-
-[[nodiscard]] std::string toStdString(const QString& s) {
-  return s.toStdString();
-}
-
-}  // namespace
-
 QString joinStrings(const std::vector<std::string>& list, QString placeholder) {
   if (list.empty()) return placeholder;
   return QString::fromStdString(nstd::join(list, ", "));
 }
 
+QString joinStrings(const std::vector<std::string_view>& list, QString placeholder) {
+  if (list.empty()) return placeholder;
+  QString str;
+  for (const auto& item : list) {
+    if (!str.isEmpty()) str += u", "_s;
+    str += QString::fromUtf8(item);
+  }
+  return str;
+}
+
 void removeHtmlTags(QString& str) {
   static const QRegularExpression re{"<[a-z/]+>"};
   str.remove(re);
@@ -63,6 +65,59 @@ QString& replaceWholeWord(QString& str, const QString& before, const QString& af
   return str;
 }
 
+// Encodes UTF-16 as UTF-8 straight into the result, which saves the intermediate `QByteArray`
+// that `QString::toStdString()` allocates. Unpaired surrogates become U+FFFD.
+std::string toStdString(QStringView str) {
+  const auto isSurrogatePair = [&str](qsizetype i) {
+    return QChar::isHighSurrogate(str[i].unicode()) && i + 1 < str.size() &&
+           QChar::isLowSurrogate(str[i + 1].unicode());
+  };
+
+  size_t length = 0;
+  for (qsizetype i = 0; i < str.size(); ++i) {
+    const char16_t c = str[i].unicode();
+    if (c < 0x80) {
+      length += 1;
+    } else if (c < 0x800) {
+      length += 2;
+    } else if (isSurrogatePair(i)) {
+      length += 4;
+      ++i;
+    } else {
+      length += 3;
+    }
+  }
+
+  std::string result;
+  result.resize_and_overwrite(length, [&](char* data, size_t) {
+    auto out = reinterpret_cast<unsigned char*>(data);
+    for (qsizetype i = 0; i < str.size(); ++i) {
+      char32_t c = str[i].unicode();
+      if (c < 0x80) {
+        *out++ = c;
+      } else if (c < 0x800) {
+        *out++ = 0xC0 | (c >> 6);
+        *out++ = 0x80 | (c & 0x3F);
+      } else if (isSurrogatePair(i)) {
+        c = QChar::surrogateToUcs4(str[i].unicode(), str[i + 1].unicode());
+        *out++ = 0xF0 | (c >> 18);
+        *out++ = 0x80 | ((c >> 12) & 0x3F);
+        *out++ = 0x80 | ((c >> 6) & 0x3F);
+        *out++ = 0x80 | (c & 0x3F);
+        ++i;
+      } else {
+        if (QChar::isSurrogate(c)) c = QChar::ReplacementCharacter;
+        *out++ = 0xE0 | (c >> 12);
+        *out++ = 0x80 | ((c >> 6) & 0x3F);
+        *out++ = 0x80 | (c & 0x3F);
+      }
+    }
+    return length;
+  });
+
+  return result;
+}
+
 std::vector<std::string> toVector(const QStringList& list) {
   return list | std::views::transform(toStdString) | std::ranges::to<std::vector>();
 }
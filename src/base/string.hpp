@@ -20,12 +20,16 @@
 
 #include <QList>
 #include <QString>
+#include <QStringView>
 #include <string>
+#include <string_view>
 #include <vector>
 
 using namespace Qt::Literals::StringLiterals;
 
 QString joinStrings(const std::vector<std::string>& list, QString placeholder = "?");
+QString joinStrings(const std::vector<std::string_view>& list, QString placeholder = "?");
 void removeHtmlTags(QString& str);
 QString& replaceWholeWord(QString& str, const QString& before, const QString& after);
+std::string toStdString(QStringView str);
 std::vector<std::string> toVector(const QStringList& list);
@@ -0,0 +1,91 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2024, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "symbol_table.hpp"
+
+#include <mutex>
+
+#include "base/log.hpp"
+
+namespace base {
+
+SymbolTable::SymbolTable() {
+  intern("");
+}
+
+SymbolTable::id_t SymbolTable::intern(std::string_view name) {
+  if (const auto id = find(name)) return *id;
+
+  const std::unique_lock lock{mutex_};
+
+  // Another thread may have interned the same name while we were waiting for the lock
+  if (const auto it = ids_.find(name); it != ids_.end()) return it->second;
+
+  const auto size = size_.load(std::memory_order_relaxed);
+  if (size == kMaxSize) {
+    if (!full_) LOGE("Symbol table is full, new names are interned as empty strings.");
+    full_ = true;
+    return kEmpty;
+  }
+
+  if (size % kChunkSize == 0) {
+    storage_.push_back(std::make_unique<std::string[]>(kChunkSize));
+    chunks_[size / kChunkSize].store(storage_.back().get(), std::memory_order_release);
+  }
+
+  auto& str = storage_[size / kChunkSize][size % kChunkSize];
+  str = name;
+
+  const auto id = static_cast<id_t>(size);
+  ids_.emplace(str, id);
+  size_.store(size + 1, std::memory_order_release);
+
+  return id;
+}
+
+std::optional<SymbolTable::id_t> SymbolTable::find(std::string_view name) const {
+  const std::shared_lock lock{mutex_};
+
+  const auto it = ids_.find(name);
+  if (it == ids_.end()) return std::nullopt;
+
+  return it->second;
+}
+
+std::string_view SymbolTable::name(const id_t id) const {
+  if (id >= size_.load(std::memory_order_acquire)) return {};
+
+  return chunks_[id / kChunkSize].load(std::memory_order_acquire)[id % kChunkSize];
+}
+
+std::vector<std::string_view> SymbolTable::names(std::span<const id_t> ids) const {
+  std::vector<std::string_view> names;
+  names.reserve(ids.size());
+
+  for (const auto id : ids) {
+    names.push_back(name(id));
+  }
+
+  return names;
+}
+
+size_t SymbolTable::size() const {
+  return size_.load(std::memory_order_acquire);
+}
+
+}  // namespace base
@@ -0,0 +1,71 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2024, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace base {
+
+// Maps strings to compact ids, so that each distinct string is stored only once. Interning is
+// thread-safe, and names can be looked up without locking.
+class SymbolTable final {
+public:
+  using id_t = uint16_t;
+
+  // The empty string always has the id 0, which is also returned when the table is full. Names
+  // with this id must not be written back to the disk.
+  static constexpr id_t kEmpty = 0;
+
+  SymbolTable();
+  ~SymbolTable() = default;
+
+  id_t intern(std::string_view name);
+  std::optional<id_t> find(std::string_view name) const;
+
+  std::string_view name(const id_t id) const;
+  std::vector<std::string_view> names(std::span<const id_t> ids) const;
+
+  size_t size() const;
+
+private:
+  static constexpr size_t kChunkSize = 256;
+  static constexpr size_t kMaxSize = size_t{std::numeric_limits<id_t>::max()} + 1;
+
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<std::string_view, id_t> ids_;
+  std::vector<std::unique_ptr<std::string[]>> storage_;
+
+  // Names are published through these, so that readers don't need the lock
+  std::array<std::atomic<const std::string*>, kMaxSize / kChunkSize> chunks_{};
+  std::atomic<size_t> size_ = 0;
+  bool full_ = false;
+};
+
+}  // namespace base
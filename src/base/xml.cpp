@@ -18,6 +18,14 @@
 
 #include "xml.hpp"
 
+#include <algorithm>
+
+namespace {
+
+constexpr qint64 kChunkSize = 1024 * 1024;
+
+}  // namespace
+
 namespace base {
 
 const QFile& XmlFileReader::file() const {
@@ -41,4 +49,78 @@ bool XmlFileReader::readElement(QAnyStringView name) {
   return QXmlStreamReader::readNextStartElement() && QXmlStreamReader::name() == name;
 }
 
+const QFile& XmlElementScanner::file() const {
+  return file_;
+}
+
+bool XmlElementScanner::open(const QString& name, QByteArrayView element) {
+  startTag_ = "<" + element.toByteArray();
+  endTag_ = "</" + element.toByteArray() + ">";
+
+  buffer_.clear();
+  position_ = 0;
+
+  file_.setFileName(name);
+
+  return file_.open(QIODevice::ReadOnly);
+}
+
+bool XmlElementScanner::readElement(QByteArray& fragment) {
+  while (true) {
+    if (const auto start = findStartTag(); start != -1) {
+      position_ = start;
+      break;
+    }
+    // The tail of the buffer may contain the beginning of a tag that is split between chunks
+    position_ = std::max(position_, buffer_.size() - startTag_.size());
+    if (!readChunk()) return false;
+  }
+
+  qsizetype end = -1;
+  while ((end = buffer_.indexOf(endTag_, position_)) == -1) {
+    if (!readChunk()) return false;
+  }
+  end += endTag_.size();
+
+  fragment = buffer_.sliced(position_, end - position_);
+  position_ = end;
+
+  return true;
+}
+
+int XmlElementScanner::progress() const {
+  if (file_.size() == 0) return 100;
+  return static_cast<int>(file_.pos() * 100 / file_.size());
+}
+
+qsizetype XmlElementScanner::findStartTag() const {
+  for (auto i = buffer_.indexOf(startTag_, position_); i != -1;
+       i = buffer_.indexOf(startTag_, i + 1)) {
+    const auto next = i + startTag_.size();
+    // We can't tell whether this is the element or only a prefix of another name yet
+    if (next == buffer_.size()) return -1;
+    switch (buffer_[next]) {
+      case '>':
+      case ' ':
+      case '\t':
+      case '\r':
+      case '\n':
+        return i;
+    }
+  }
+  return -1;
+}
+
+bool XmlElementScanner::readChunk() {
+  if (file_.atEnd()) return false;
+
+  // Everything before the current position has already been handled
+  buffer_.remove(0, position_);
+  position_ = 0;
+
+  buffer_.append(file_.read(kChunkSize));
+
+  return true;
+}
+
 }  // namespace base
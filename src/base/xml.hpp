@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <QByteArray>
 #include <QFile>
 #include <QString>
 #include <QXmlStreamReader>
@@ -36,4 +37,28 @@ private:
   QFile file_;
 };
 
+// Reads a document in chunks, and extracts each occurrence of an element as a separate fragment
+// that can be parsed on its own, possibly on another thread. This keeps memory usage low for
+// large documents. Elements with the given name must not be nested within each other.
+class XmlElementScanner {
+public:
+  const QFile& file() const;
+
+  bool open(const QString& name, QByteArrayView element);
+  bool readElement(QByteArray& fragment);
+
+  // Returns how much of the file has been read, as a percentage
+  int progress() const;
+
+private:
+  qsizetype findStartTag() const;
+  bool readChunk();
+
+  QFile file_;
+  QByteArray buffer_;
+  qsizetype position_ = 0;
+  QByteArray startTag_;
+  QByteArray endTag_;
+};
+
 }  // namespace base
@@ -0,0 +1,297 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2024, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Measures the anime database at realistic scale, with synthetic catalogues that are generated
+// into a temporary directory. Results are written as JSON, so that they can be compared across
+// releases.
+//
+// Usage: taiga-db-bench [--sizes 10000,50000,200000] [--seed 1] [--output results.json]
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "base/file.hpp"
+#include "base/string.hpp"
+#include "bench/synthetic_catalogue.hpp"
+#include "media/anime.hpp"
+#include "media/anime_db.hpp"
+#include "taiga/path.hpp"
+#include "taiga/version.hpp"
+
+namespace {
+
+constexpr int kPointLookups = 1'000'000;
+constexpr int kExtrasLookups = 1'000;
+
+// Initializes the database and waits until it has finished loading or migrating
+void initDatabase(anime::Database& db) {
+  QEventLoop loop;
+  QObject::connect(&db, &anime::Database::ready, &loop, &QEventLoop::quit);
+  db.init();
+  if (!db.isReady()) loop.exec();
+}
+
+double perSecond(const qsizetype count, const qint64 ms) {
+  return ms > 0 ? count * 1000.0 / ms : 0.0;
+}
+
+// Decodes each row the way the database did before columns were read by ordinal
+Anime itemByName(const QSqlQuery& q) {
+  return {
+      .id = q.value("id").toInt(),
+      .last_modified = q.value("modified").toLongLong(),
+      .episode_count = q.value("episode_count").toInt(),
+      .episode_length = q.value("episode_length").toInt(),
+      .age_rating = q.value("age_rating").value<anime::AgeRating>(),
+      .status = q.value("status").value<anime::Status>(),
+      .type = q.value("type").value<anime::Type>(),
+      .date_started = FuzzyDate(q.value("date_start").toString().toStdString()),
+      .date_finished = FuzzyDate(q.value("date_end").toString().toStdString()),
+      .score = q.value("score").toFloat(),
+      .popularity_rank = q.value("popularity").toInt(),
+      .titles{
+          .romaji = q.value("title").toString().toStdString(),
+          .english = q.value("english").toString().toStdString(),
+          .japanese = q.value("japanese").toString().toStdString(),
+      },
+      .last_aired_episode = q.value("last_aired_episode").toInt(),
+      .next_episode_time = q.value("next_episode_time").toLongLong(),
+  };
+}
+
+// Decodes each row the way the database does, with the column order of `selectAnime.sql`
+Anime itemByOrdinal(const QSqlQuery& q) {
+  return {
+      .id = q.value(0).toInt(),
+      .last_modified = q.value(15).toLongLong(),
+      .episode_count = q.value(6).toInt(),
+      .episode_length = q.value(7).toInt(),
+      .age_rating = static_cast<anime::AgeRating>(q.value(10).toInt()),
+      .status = static_cast<anime::Status>(q.value(5).toInt()),
+      .type = static_cast<anime::Type>(q.value(4).toInt()),
+      .date_started = FuzzyDate(toStdString(q.value(8).toString())),
+      .date_finished = FuzzyDate(toStdString(q.value(9).toString())),
+      .score = q.value(11).toFloat(),
+      .popularity_rank = q.value(12).toInt(),
+      .titles{
+          .romaji = toStdString(q.value(1).toString()),
+          .english = toStdString(q.value(2).toString()),
+          .japanese = toStdString(q.value(3).toString()),
+      },
+      .last_aired_episode = q.value(13).toInt(),
+      .next_episode_time = q.value(14).toLongLong(),
+  };
+}
+
+// Reads every item with `decode`, and returns the number of rows per second
+template <typename Decode>
+double measureDecode(const QSqlDatabase& db, Decode decode) {
+  QSqlQuery q{db};
+  q.setForwardOnly(true);
+
+  QElapsedTimer timer;
+  timer.start();
+
+  if (!q.exec(base::readFile(u":/sql/selectAnime.sql"_s))) return 0.0;
+
+  qsizetype rows = 0;
+  while (q.next()) {
+    const auto item = decode(q);
+    if (item.id) ++rows;
+  }
+
+  return perSecond(rows, timer.elapsed());
+}
+
+QJsonObject run(const int size, const uint32_t seed) {
+  QJsonObject result;
+  QElapsedTimer timer;
+
+  timer.start();
+  const auto items = bench::generateCatalogue(size, seed);
+  const auto entries = bench::generateList(items, seed);
+  const auto rows = static_cast<qsizetype>(items.size() + entries.size());
+
+  result["items"] = static_cast<qint64>(items.size());
+  result["entries"] = static_cast<qint64>(entries.size());
+  result["generate_ms"] = timer.elapsed();
+
+  QTemporaryDir dir;
+  taiga::set_data_path(dir.path().toStdString());
+
+  // Bulk upsert into a new database
+  {
+    anime::Database db;
+    initDatabase(db);
+
+    timer.start();
+    db.updateItems(items);
+    result["bulk_upsert_ms"] = timer.elapsed();
+    result["bulk_upsert_rows_per_second"] = perSecond(items.size(), timer.elapsed());
+
+    // Closing waits for the list entries to be written, and writes the cache image
+    db.updateEntries(entries);
+    timer.start();
+    db.close();
+    result["close_ms"] = timer.elapsed();
+  }
+
+  // Load from SQLite
+  QFile::remove(dir.filePath("media.cache"));
+  {
+    anime::Database db;
+
+    timer.start();
+    initDatabase(db);
+    result["load_ms"] = timer.elapsed();
+    result["load_rows_per_second"] = perSecond(rows, timer.elapsed());
+
+    std::mt19937 engine{seed};
+    std::uniform_int_distribution<int> ids{1, size};
+
+    std::vector<int> lookups(kPointLookups);
+    for (auto& id : lookups) id = ids(engine);
+
+    size_t found = 0;
+    timer.start();
+    for (const int id : lookups) {
+      if (db.item(id)) ++found;
+      if (db.entry(id)) ++found;
+    }
+    result["point_lookup_ns"] = static_cast<double>(timer.nsecsElapsed()) / kPointLookups;
+    result["point_lookup_found"] = static_cast<qint64>(found);
+
+    // Mostly misses in the cache of extras, so these are read from SQLite
+    timer.start();
+    for (int i = 0; i < kExtrasLookups; ++i) {
+      db.extras(ids(engine));
+    }
+    result["extras_lookup_us"] = timer.nsecsElapsed() / 1000.0 / kExtrasLookups;
+
+    db.close();
+  }
+
+  // Row decoding by column name and by column ordinal, on the same rows
+  {
+    const auto connectionName = u"taiga-db-bench"_s;
+    {
+      auto db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+      db.setDatabaseName(dir.filePath("media.sqlite"));
+      db.setConnectOptions("QSQLITE_OPEN_READONLY");
+      if (db.open()) {
+        measureDecode(db, itemByOrdinal);  // warms up the page cache
+        result["decode_by_name_rows_per_second"] = measureDecode(db, itemByName);
+        result["decode_by_ordinal_rows_per_second"] = measureDecode(db, itemByOrdinal);
+        db.close();
+      }
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+  }
+
+  // Load from the cache image that was written on close
+  {
+    anime::Database db;
+
+    timer.start();
+    initDatabase(db);
+    result["cache_load_ms"] = timer.elapsed();
+    result["cache_load_rows_per_second"] = perSecond(rows, timer.elapsed());
+
+    db.close();
+  }
+
+  // Migration from v1
+  {
+    QTemporaryDir v1Dir;
+    taiga::set_data_path(v1Dir.path().toStdString());
+
+    QDir{v1Dir.path()}.mkpath("v1/db");
+    bench::writeV1Catalogue(v1Dir.filePath("v1/db/anime.xml").toStdString(), items);
+
+    anime::Database db;
+
+    timer.start();
+    initDatabase(db);
+    result["migration_ms"] = timer.elapsed();
+    result["migration_rows_per_second"] = perSecond(items.size(), timer.elapsed());
+
+    db.close();
+  }
+
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  QCoreApplication app(argc, argv);
+  QCoreApplication::setApplicationName("taiga-db-bench");
+
+  QCommandLineParser parser;
+  parser.addHelpOption();
+  parser.addOptions({
+      {"sizes", "Comma-separated catalogue sizes.", "sizes", "10000,50000,200000"},
+      {"seed", "Seed of the synthetic catalogues.", "seed", "1"},
+      {"output", "Writes the results to a file rather than stdout.", "file"},
+  });
+  parser.process(app);
+
+  const auto seed = parser.value("seed").toUInt();
+
+  QJsonArray results;
+
+  for (const auto& value : parser.value("sizes").split(',', Qt::SkipEmptyParts)) {
+    const int size = value.toInt();
+    if (size <= 0) continue;
+    results.append(run(size, seed));
+  }
+
+  const QJsonObject report{
+      {"version", QString::fromStdString(taiga::version().to_string())},
+      {"seed", static_cast<qint64>(seed)},
+      {"results", results},
+  };
+
+  const auto json = QJsonDocument{report}.toJson();
+
+  if (parser.isSet("output")) {
+    QFile file{parser.value("output")};
+    if (!file.open(QIODevice::WriteOnly)) {
+      std::fprintf(stderr, "%s\n", file.errorString().toLocal8Bit().constData());
+      return 1;
+    }
+    file.write(json);
+  } else {
+    std::fwrite(json.constData(), 1, json.size(), stdout);
+  }
+
+  return 0;
+}
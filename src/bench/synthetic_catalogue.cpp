@@ -0,0 +1,414 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2024, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "synthetic_catalogue.hpp"
+
+#include <QFile>
+#include <QStringList>
+#include <QXmlStreamWriter>
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <format>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <type_traits>
+
+#include "base/string.hpp"
+
+namespace {
+
+constexpr std::array<std::string_view, 40> kRomajiWords{
+    "ai",     "boku",       "hoshi",    "kimi",    "koi",     "kaze",    "sora",   "yume",
+    "hikari", "kokoro",     "mirai",    "sekai",   "tenshi",  "akuma",   "majo",   "yuusha",
+    "maou",   "gakuen",     "shoujo",   "shounen", "senpai",  "kaijuu",  "tsuki",  "hana",
+    "umi",    "yoru",       "asa",      "natsu",   "fuyu",    "haru",    "aki",    "tabi",
+    "ninja",  "monogatari", "densetsu", "kiseki",  "kami",    "samurai", "robot",  "neko",
+};
+
+constexpr std::array<std::string_view, 40> kEnglishWords{
+    "Academy", "Alchemist", "Blade",   "Dragon",  "Dream",  "Knight", "Legend",  "Magic",
+    "Memory",  "Moon",      "Night",   "Ocean",   "Queen",  "Quest",  "Rain",    "Promise",
+    "Record",  "Revenge",   "Saga",    "School",  "Shadow", "Sky",    "Song",    "Spirit",
+    "Star",    "Story",     "Summer",  "Sword",   "Tale",   "Tower",  "Journey", "War",
+    "Witch",   "World",     "Wing",    "Winter",  "Heart",  "Hero",   "Fire",    "Garden",
+};
+
+constexpr std::array<std::string_view, 18> kGenres{
+    "Action",  "Adventure",    "Comedy", "Drama",   "Ecchi",         "Fantasy",
+    "Horror",  "Mahou Shoujo", "Mecha",  "Music",   "Mystery",       "Psychological",
+    "Romance", "Sci-Fi",       "Sports", "Thriller", "Slice of Life", "Supernatural",
+};
+
+// Tags are combinations of these, which gives a long tail of rarely used ones
+constexpr std::array<std::string_view, 12> kTagAdjectives{
+    "Female", "Male",  "Ensemble", "Episodic", "Urban", "Rural",
+    "Tragic", "Space", "Military", "Virtual",  "Found", "Super",
+};
+
+constexpr std::array<std::string_view, 16> kTagNouns{
+    "Protagonist", "Cast",  "Setting", "Travel", "Academy",  "Power",      "Robots",    "Opera",
+    "Idol",        "Club",  "Family",  "Rivalry", "Survival", "Conspiracy", "Detective", "Reality",
+};
+
+constexpr std::array<std::string_view, 12> kStudios{
+    "Studio Alpha", "Studio Beta", "Studio Gamma", "Studio Delta",  "Studio Epsilon", "Studio Zeta",
+    "Studio Eta",   "Studio Theta", "Studio Iota", "Studio Kappa", "Studio Lambda",  "Studio Mu",
+};
+
+constexpr std::array<std::string_view, 6> kSequelSuffixes{
+    "2nd Season", "Season 3", "Movie", "OVA", "Specials", "Final Season",
+};
+
+constexpr std::string_view kKana =
+    "あいうえおかきくけこさしすせそたちつてとなにぬねのはひふへほまみむめもやゆよらりるれろわをん";
+
+class Generator final {
+public:
+  explicit Generator(const uint32_t seed) : engine_{seed} {}
+
+  int uniform(const int min, const int max) {
+    return std::uniform_int_distribution<int>{min, max}(engine_);
+  }
+
+  bool chance(const double probability) {
+    return std::bernoulli_distribution{probability}(engine_);
+  }
+
+  double real() {
+    return std::uniform_real_distribution<double>{0.0, 1.0}(engine_);
+  }
+
+  // Approximates a Zipf distribution, where lower indexes are much more likely
+  size_t zipf(const size_t count) {
+    const auto index = static_cast<size_t>(std::pow(static_cast<double>(count) + 1.0, real())) - 1;
+    return std::min(index, count - 1);
+  }
+
+  const auto& pick(const auto& values) {
+    return values[zipf(std::size(values))];
+  }
+
+  template <typename T>
+  T weighted(std::initializer_list<std::pair<T, double>> values) {
+    std::vector<double> weights;
+    for (const auto& [value, weight] : values) weights.push_back(weight);
+    const auto index = std::discrete_distribution<size_t>{weights.begin(), weights.end()}(engine_);
+    return values.begin()[index].first;
+  }
+
+  std::string words(const auto& pool, const int min, const int max, std::string_view separator) {
+    std::string str;
+    for (int i = uniform(min, max); i > 0; --i) {
+      if (!str.empty()) str += separator;
+      str += pick(pool);
+    }
+    return str;
+  }
+
+  std::string kana(const int min, const int max) {
+    constexpr int kCharSize = 3;  // in UTF-8
+    constexpr int kCharCount = static_cast<int>(kKana.size()) / kCharSize;
+    std::string str;
+    for (int i = uniform(min, max); i > 0; --i) {
+      str += kKana.substr(uniform(0, kCharCount - 1) * kCharSize, kCharSize);
+    }
+    return str;
+  }
+
+  std::vector<anime::Symbol> symbols(const auto& pool, const int min, const int max) {
+    std::vector<anime::Symbol> symbols;
+    for (int i = uniform(min, max); i > 0; --i) {
+      const auto symbol = anime::symbols.intern(pick(pool));
+      if (!std::ranges::contains(symbols, symbol)) symbols.push_back(symbol);
+    }
+    return symbols;
+  }
+
+private:
+  std::mt19937 engine_;
+};
+
+std::string capitalize(std::string str) {
+  if (!str.empty()) str.front() = static_cast<char>(std::toupper(str.front()));
+  return str;
+}
+
+std::string slugify(std::string_view str) {
+  std::string slug;
+  for (const char c : str) {
+    if (std::isalnum(static_cast<unsigned char>(c))) {
+      slug += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    } else if (!slug.empty() && slug.back() != '-') {
+      slug += '-';
+    }
+  }
+  return slug;
+}
+
+QString joinSymbols(const std::vector<anime::Symbol>& symbols) {
+  QStringList names;
+  for (const auto& name : anime::symbols.names(symbols)) {
+    names.push_back(QString::fromStdString(std::string{name}));
+  }
+  return names.join(", ");
+}
+
+// Items are dated relative to this, rather than to the current time
+constexpr std::time_t kBaseTime = 1735689600;  // 2025-01-01
+
+}  // namespace
+
+namespace bench {
+
+std::vector<Anime> generateCatalogue(const size_t size, const uint32_t seed) {
+  Generator generator{seed};
+
+  std::vector<std::string> tags;
+  for (const auto adjective : kTagAdjectives) {
+    for (const auto noun : kTagNouns) {
+      tags.push_back(std::format("{} {}", adjective, noun));
+    }
+  }
+  std::ranges::shuffle(tags, std::mt19937{seed});
+
+  std::vector<Anime> items;
+  items.reserve(size);
+
+  for (size_t i = 0; i < size; ++i) {
+    Anime item;
+    auto extras = std::make_shared<anime::Extras>();
+
+    item.id = static_cast<int>(i) + 1;
+
+    // Sequels share the titles of an earlier item
+    if (!items.empty() && generator.chance(0.25)) {
+      const auto& prequel = items[generator.uniform(0, static_cast<int>(items.size()) - 1)];
+      const auto suffix = generator.pick(kSequelSuffixes);
+      item.titles.romaji = std::format("{} {}", prequel.titles.romaji, suffix);
+      if (!prequel.titles.english.empty()) {
+        item.titles.english = std::format("{} {}", prequel.titles.english, suffix);
+      }
+      item.titles.japanese = prequel.titles.japanese;
+    } else {
+      item.titles.romaji = capitalize(generator.words(kRomajiWords, 1, 5, " no "));
+      if (generator.chance(0.6)) {
+        item.titles.english = std::format("The {}", generator.words(kEnglishWords, 1, 4, " "));
+      }
+      if (generator.chance(0.8)) item.titles.japanese = generator.kana(3, 12);
+    }
+    for (int j = generator.uniform(-2, 3); j > 0; --j) {
+      item.titles.synonyms.push_back(capitalize(generator.words(kRomajiWords, 1, 3, " ")));
+    }
+
+    item.type = generator.weighted<anime::Type>({
+        {anime::Type::Tv, 45},
+        {anime::Type::Movie, 15},
+        {anime::Type::Ova, 12},
+        {anime::Type::Special, 10},
+        {anime::Type::Ona, 13},
+        {anime::Type::Music, 5},
+    });
+
+    // Recent years have many more titles
+    const double u = generator.real();
+    const int year = 2025 - static_cast<int>(55 * u * u);
+    const auto month = static_cast<unsigned>(generator.uniform(1, 12));
+    const auto day = static_cast<unsigned>(generator.uniform(1, 28));
+    item.date_started =
+        FuzzyDate{std::chrono::year{year}, std::chrono::month{month}, std::chrono::day{day}};
+
+    item.status = year < 2025                ? anime::Status::FinishedAiring
+                  : generator.chance(0.5)    ? anime::Status::Airing
+                                             : anime::Status::NotYetAired;
+
+    switch (item.type) {
+      case anime::Type::Tv:
+        item.episode_count = generator.weighted<int>({{12, 40}, {13, 15}, {24, 20}, {26, 10},
+                                                      {50, 5}, {anime::kUnknownEpisodeCount, 10}});
+        item.episode_length = 24;
+        break;
+      case anime::Type::Movie:
+        item.episode_count = 1;
+        item.episode_length = generator.uniform(60, 150);
+        break;
+      case anime::Type::Music:
+        item.episode_count = 1;
+        item.episode_length = generator.uniform(3, 6);
+        break;
+      default:
+        item.episode_count = generator.uniform(1, 12);
+        item.episode_length = generator.uniform(5, 30);
+        break;
+    }
+
+    if (item.status == anime::Status::FinishedAiring && item.episode_count > 1) {
+      item.date_finished = FuzzyDate{std::chrono::year{year + (item.episode_count > 26 ? 1 : 0)},
+                                     std::chrono::month{month % 12 + 1}, std::chrono::day{1}};
+    } else if (item.status == anime::Status::Airing) {
+      item.last_aired_episode = generator.uniform(1, std::max(item.episode_count, 1));
+      item.next_episode_time = kBaseTime + generator.uniform(0, 7 * 24 * 60 * 60);
+    }
+
+    item.age_rating = generator.weighted<anime::AgeRating>({
+        {anime::AgeRating::PG13, 60},
+        {anime::AgeRating::G, 10},
+        {anime::AgeRating::PG, 15},
+        {anime::AgeRating::R17, 13},
+        {anime::AgeRating::R18, 2},
+    });
+    item.score = static_cast<float>(generator.uniform(40, 90));
+    item.popularity_rank = generator.uniform(1, static_cast<int>(size));
+    item.last_modified = kBaseTime - generator.uniform(0, 365 * 24 * 60 * 60);
+
+    item.genres = generator.symbols(kGenres, 1, 4);
+    item.tags = generator.symbols(tags, 0, 12);
+    item.studios = generator.symbols(kStudios, 1, 2);
+    item.producers = generator.symbols(kStudios, 0, 4);
+
+    extras->image_url = std::format("https://example.com/images/{}.jpg", item.id);
+    extras->slug = slugify(item.titles.romaji);
+    extras->synopsis = generator.words(kEnglishWords, 40, 150, " ");
+    if (generator.chance(0.3)) extras->trailer_id = std::format("trailer{:04}", item.id % 10000);
+    item.extras = std::move(extras);
+
+    items.push_back(std::move(item));
+  }
+
+  return items;
+}
+
+std::vector<ListEntry> generateList(std::span<const Anime> items, const uint32_t seed) {
+  Generator generator{seed};
+
+  const size_t size = std::min(items.size(), 1000 + items.size() / 50);
+
+  std::vector<ListEntry> entries;
+  entries.reserve(size);
+
+  // Popular items are more likely to be in the list
+  std::vector<size_t> indexes(items.size());
+  std::ranges::iota(indexes, size_t{0});
+  std::ranges::sort(indexes, {}, [&items](const size_t i) { return items[i].popularity_rank; });
+
+  for (size_t i = 0; i < size; ++i) {
+    const auto& item = items[indexes[generator.zipf(indexes.size())]];
+    if (std::ranges::contains(entries, item.id, &ListEntry::anime_id)) continue;
+
+    ListEntry entry;
+    entry.id = 100'000'000 + static_cast<int64_t>(i);
+    entry.anime_id = item.id;
+    entry.status = generator.weighted<anime::list::Status>({
+        {anime::list::Status::Completed, 55},
+        {anime::list::Status::Watching, 8},
+        {anime::list::Status::OnHold, 7},
+        {anime::list::Status::Dropped, 8},
+        {anime::list::Status::PlanToWatch, 22},
+    });
+
+    const int episodeCount = std::max(item.episode_count, 1);
+    switch (entry.status) {
+      case anime::list::Status::Completed:
+        entry.watched_episodes = episodeCount;
+        entry.rewatched_times = generator.chance(0.1) ? generator.uniform(1, 3) : 0;
+        entry.score = generator.uniform(50, 100);
+        break;
+      case anime::list::Status::PlanToWatch:
+        break;
+      default:
+        entry.watched_episodes = generator.uniform(0, episodeCount - 1);
+        break;
+    }
+
+    entry.last_updated = kBaseTime - generator.uniform(0, 5 * 365 * 24 * 60 * 60);
+    if (generator.chance(0.05)) entry.notes = generator.words(kEnglishWords, 1, 8, " ");
+
+    entries.push_back(std::move(entry));
+  }
+
+  return entries;
+}
+
+bool writeV1Catalogue(const std::string& path, std::span<const Anime> items) {
+  QFile file{QString::fromStdString(path)};
+
+  if (!file.open(QIODevice::WriteOnly)) return false;
+
+  QXmlStreamWriter xml{&file};
+  xml.setAutoFormatting(true);
+
+  const auto write = [&xml](const QString& name, const auto& value) {
+    if constexpr (std::is_convertible_v<decltype(value), std::string_view>) {
+      xml.writeTextElement(name, QString::fromStdString(std::string{value}));
+    } else if constexpr (std::is_same_v<std::decay_t<decltype(value)>, QString>) {
+      xml.writeTextElement(name, value);
+    } else {
+      xml.writeTextElement(name, QString::number(value));
+    }
+  };
+
+  xml.writeStartDocument();
+
+  // v1 writes this as a second root element
+  xml.writeStartElement("meta");
+  xml.writeTextElement("version", "1.4.0");
+  xml.writeEndElement();
+
+  xml.writeStartElement("database");
+
+  for (const auto& item : items) {
+    xml.writeStartElement("anime");
+    write("id", item.id);
+    write("slug", item.extras->slug);
+    write("title", item.titles.romaji);
+    write("english", item.titles.english);
+    write("japanese", item.titles.japanese);
+    for (const auto& synonym : item.titles.synonyms) {
+      write("synonym", synonym);
+    }
+    write("type", static_cast<int>(item.type));
+    write("status", static_cast<int>(item.status));
+    write("episode_count", item.episode_count);
+    write("episode_length", item.episode_length);
+    write("date_start", item.date_started.to_string());
+    write("date_end", item.date_finished.to_string());
+    write("image", item.extras->image_url);
+    write("trailer_id", item.extras->trailer_id);
+    write("age_rating", static_cast<int>(item.age_rating));
+    write("genres", joinSymbols(item.genres));
+    write("tags", joinSymbols(item.tags));
+    write("producers", joinSymbols(item.producers));
+    write("studios", joinSymbols(item.studios));
+    write("score", item.score);
+    write("popularity", item.popularity_rank);
+    write("synopsis", item.extras->synopsis);
+    write("last_aired_episode", item.last_aired_episode);
+    write("next_episode_time", static_cast<qint64>(item.next_episode_time));
+    write("modified", static_cast<qint64>(item.last_modified));
+    xml.writeEndElement();
+  }
+
+  xml.writeEndElement();
+  xml.writeEndDocument();
+
+  return !xml.hasError();
+}
+
+}  // namespace bench
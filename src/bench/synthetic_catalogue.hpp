@@ -0,0 +1,41 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2024, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "media/anime.hpp"
+#include "media/anime_list.hpp"
+
+namespace bench {
+
+// Catalogues are deterministic: the same size and seed always generate the same items. Titles,
+// genres and tags follow a long-tailed distribution, with a share of sequels of earlier titles.
+std::vector<Anime> generateCatalogue(const size_t size, const uint32_t seed);
+
+// Generates a list that is about as large as a heavy user's
+std::vector<ListEntry> generateList(std::span<const Anime> items, const uint32_t seed);
+
+// Writes the items in the format of v1's anime database, for measuring the migration
+bool writeV1Catalogue(const std::string& path, std::span<const Anime> items);
+
+}  // namespace bench
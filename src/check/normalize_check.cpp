@@ -0,0 +1,259 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2024, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Checks that `track::recognition::normalize()` gives the same result as the original pipeline,
+// which replaced one word at a time over a `QString`. The corpus is made of common title patterns
+// and of random sequences of the words that are replaced, along with the characters around them.
+//
+// Usage: taiga-normalize-check [--count 1000000] [--seed 1]
+
+#include <utf8proc.h>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QList>
+#include <QString>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "base/string.hpp"
+#include "track/recognition_normalize.hpp"
+
+namespace reference {
+
+void erasePunctuation(QString& str) {
+  static constexpr auto is_removable = [&](const QChar& c) {
+    // Control codes, white-space and punctuation characters
+    if (c.unicode() <= 0xFF && !c.isLetterOrNumber()) return true;
+    // Unicode stars, hearts, notes, etc.
+    if (c.unicode() > 0x2000 && c.unicode() < 0x2767) return true;
+    // Valid character
+    return false;
+  };
+
+  str.removeIf(is_removable);
+}
+
+void normalizeOrdinalNumbers(QString& str) {
+  static const QList<QPair<const char*, const char*>> ordinals{
+      // clang-format off
+      {"first",   "1st"},
+      {"second",  "2nd"},
+      {"third",   "3rd"},
+      {"fourth",  "4th"},
+      {"fifth",   "5th"},
+      {"sixth",   "6th"},
+      {"seventh", "7th"},
+      {"eighth",  "8th"},
+      {"ninth",   "9th"},
+      // clang-format on
+  };
+
+  for (auto [before, after] : ordinals) {
+    replaceWholeWord(str, before, after);
+  }
+}
+
+void normalizeRomanNumbers(QString& str) {
+  static const QList<QPair<const char*, const char*>> numerals{
+      // clang-format off
+      {"II",    "2"},
+      {"III",   "3"},
+      {"IV",    "4"},
+      {"V",     "5"},
+      {"VI",    "6"},
+      {"VII",   "7"},
+      {"VIII",  "8"},
+      {"IX",    "9"},
+      {"XI",   "11"},
+      {"XII",  "12"},
+      {"XIII", "13"},
+      // clang-format on
+  };
+
+  for (auto [before, after] : numerals) {
+    replaceWholeWord(str, before, after);
+  }
+}
+
+void normalizeSeasonNumbers(QString& str) {
+  static const QList<QPair<const char*, QList<const char*>>> values{
+      {"1", {"1st season", "season 1", "series 1", "s1"}},
+      {"2", {"2nd season", "season 2", "series 2", "s2"}},
+      {"3", {"3rd season", "season 3", "series 3", "s3"}},
+      {"4", {"4th season", "season 4", "series 4", "s4"}},
+      {"5", {"5th season", "season 5", "series 5", "s5"}},
+      {"6", {"6th season", "season 6", "series 6", "s6"}},
+  };
+
+  for (auto [after, list] : values) {
+    for (auto before : list) {
+      replaceWholeWord(str, before, after);
+    }
+  }
+}
+
+// The original passed the UTF-16 data of the string to utf8proc as if it were UTF-8, which is
+// corrected here, as it is in the new pipeline
+void normalizeUnicode(QString& str) {
+  constexpr int options = UTF8PROC_COMPAT | UTF8PROC_COMPOSE | UTF8PROC_STABLE |
+                          UTF8PROC_IGNORE | UTF8PROC_STRIPCC | UTF8PROC_STRIPMARK |
+                          UTF8PROC_LUMP | UTF8PROC_CASEFOLD;
+
+  const auto input = str.toUtf8();
+  utf8proc_uint8_t* buffer = nullptr;
+
+  const auto length = utf8proc_map(reinterpret_cast<const utf8proc_uint8_t*>(input.data()),
+                                   input.size(), &buffer, static_cast<utf8proc_option_t>(options));
+
+  if (length >= 0) {
+    str = QString::fromUtf8(reinterpret_cast<const char*>(buffer), length);
+  }
+
+  std::free(buffer);
+}
+
+void transliterate(QString& str) {
+  for (qsizetype i = 0; i < str.size(); ++i) {
+    auto& c = str[i];
+
+    // clang-format off
+    switch (c.unicode()) {
+      case u'@': c = u'a'; break;
+      case u'×': c = u'x'; break;
+      case u'꞉': c = u':'; break;
+      case u'Ō': str.replace(i, 1, "ou"); break;
+      case u'ō': str.replace(i, 1, "ou"); break;
+      case u'ū': str.replace(i, 1, "uu"); break;
+    }
+    // clang-format on
+  }
+
+  replaceWholeWord(str, "wa", "ha");
+  replaceWholeWord(str, "e", "he");
+  replaceWholeWord(str, "o", "wo");
+}
+
+std::string normalize(const std::string& title) {
+  auto str = QString::fromStdString(title);
+
+  normalizeRomanNumbers(str);
+  transliterate(str);
+
+  normalizeUnicode(str);
+
+  normalizeOrdinalNumbers(str);
+  normalizeSeasonNumbers(str);
+
+  replaceWholeWord(str, "&", "and");
+  replaceWholeWord(str, "the animation", "");
+  replaceWholeWord(str, "the", "");
+  replaceWholeWord(str, "episode", "");
+  replaceWholeWord(str, "oad", "ova");
+  replaceWholeWord(str, "oav", "ova");
+  replaceWholeWord(str, "specials", "sp");
+  replaceWholeWord(str, "special", "sp");
+  replaceWholeWord(str, "(tv)", "");
+
+  str = str.simplified();
+  erasePunctuation(str);
+
+  return str.toStdString();
+}
+
+}  // namespace reference
+
+namespace {
+
+const std::vector<std::string> kTitles{
+    "Shingeki no Kyojin Season 2",
+    "Kimi no Na wa.",
+    "THE iDOLM@STER",
+    "Tasogare Otome × Amnesia",
+    "Nisekoi꞉",
+    "Ōkami-san",
+    "Yūki Yūna wa Yūsha de Aru",
+    "Natsume Yuujinchou Second Season",
+    "Fate/Zero 2nd Season",
+    "Toaru Majutsu no Index II",
+    "K-On!! (TV)",
+    "Tom & Jerry",
+    "Dragon Ball Z: The Movie",
+    "Ａｎｉｍｅ　Ｔｉｔｌｅ",
+    "Love★Live!",
+    "Re:Zero kara Hajimeru Isekai Seikatsu 2nd Season Part 2",
+    "Episode of Luffy OAD OAV",
+    "Hunter × Hunter (2011)",
+    "Gintama°",
+};
+
+// Words that are replaced, and characters that decide whether they are whole words
+const std::vector<std::string> kWords{
+    "the", "animation", "season", "series", "1", "2", "3", "6", "1st", "2nd", "6th", "first",
+    "second", "sixth", "seventh", "s1", "s2", "s6", "&", "(tv)", "(", "tv", ")", "special",
+    "specials", "oad", "oav", "episode", "II", "III", "IV", "V", "XIII", "wa", "e", "o", "@",
+    "×", "Ō", "ū", "꞉", " ", " ", " ", "-", ":", "!", "\t", "．", "　", "Ａ", "★", "・", "x",
+    "Kimi", "no", "TV", "The", "Season", "SECOND", "Ｓｅａｓｏｎ", "😀", "\xff",
+};
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  QCoreApplication app{argc, argv};
+
+  QCommandLineParser parser;
+  parser.addHelpOption();
+  parser.addOptions({
+      {"count", "Number of random titles", "count", "1000000"},
+      {"seed", "Random seed", "seed", "1"},
+  });
+  parser.process(app);
+
+  std::vector<std::string> corpus = kTitles;
+
+  std::mt19937 random{parser.value("seed").toUInt()};
+  const int count = parser.value("count").toInt();
+  for (int i = 0; i < count; ++i) {
+    std::string title;
+    for (int j = static_cast<int>(random() % 12); j > 0; --j) {
+      title += kWords[random() % kWords.size()];
+      if (random() % 3) title += ' ';
+    }
+    corpus.push_back(std::move(title));
+  }
+
+  size_t differences = 0;
+  std::string output;
+
+  for (const auto& title : corpus) {
+    track::recognition::normalize(title, output);
+    const auto expected = reference::normalize(title);
+    if (output == expected) continue;
+    if (++differences <= 20) {
+      std::printf("\"%s\"\n  expected: \"%s\"\n  actual:   \"%s\"\n", title.c_str(),
+                  expected.c_str(), output.c_str());
+    }
+  }
+
+  std::printf("%zu of %zu titles differ\n", differences, corpus.size());
+
+  return differences ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -19,53 +19,90 @@
 #include "anime.hpp"
 
 #include <QXmlStreamReader>
+#include <algorithm>
+#include <memory>
+#include <ranges>
+#include <vector>
 
 #include "base/log.hpp"
 #include "base/string.hpp"
-#include "base/xml.hpp"
 #include "compat/common.hpp"
+#include "sync/service.hpp"
 
 #define XML_ELEMENT xml.readElementText()
 
-namespace compat::v1 {
-
-Anime parseAnimeElement(QXmlStreamReader& xml);
-
-QList<Anime> readAnimeDatabase(const std::string& path) {
-  base::XmlFileReader xml;
-
-  if (!xml.open(QString::fromStdString(path), removeMetaElement)) {
-    LOGE("{}", xml.file().errorString().toStdString());
-    return {};
-  }
-
-  if (!xml.readElement(u"database")) {
-    xml.raiseError("Invalid anime database file.");
-  }
+namespace {
 
-  QList<Anime> db;
+std::vector<anime::Symbol> toSymbols(const QStringList& list) {
+  return list | std::views::transform([](const QString& s) {
+           return anime::symbols.intern(toStdString(s));
+         }) |
+         std::ranges::to<std::vector>();
+}
 
-  while (xml.readElement(u"anime")) {
-    db.emplace_back(parseAnimeElement(xml));
-  }
+}  // namespace
 
-  if (xml.hasError()) {
-    LOGE("{}", xml.errorString().toStdString());
-  }
+namespace compat::v1 {
 
-  return db;
+// v1 stores an `<id>` element for each service, with the slug of the service in its `name`
+// attribute. Elements without one are from before v1 supported multiple services, when all ids
+// were MyAnimeList ids.
+struct AnimeElement {
+  Anime anime;
+  std::vector<anime::Uid> uids;
+};
+
+AnimeElement parseAnimeElement(QXmlStreamReader& xml);
+
+bool readAnimeDatabase(const std::string& path, const sync::ServiceId service,
+                       const AnimeCallback& callback, std::vector<anime::Uid>& skipped) {
+  return readElements<AnimeElement>(
+      path, "anime", parseAnimeElement,
+      [service, &callback, &skipped](std::vector<AnimeElement>&& elements, const int progress) {
+        std::vector<Anime> items;
+        std::vector<anime::Uid> uids;
+
+        items.reserve(elements.size());
+
+        for (auto& [anime, elementUids] : elements) {
+          if (elementUids.empty()) {
+            elementUids.push_back(
+                {.service = sync::ServiceId::MyAnimeList, .service_id = anime.id});
+          }
+          const auto it = std::ranges::find(elementUids, service, &anime::Uid::service);
+          if (it == elementUids.end()) {
+            skipped.push_back(elementUids.front());
+            continue;
+          }
+          anime.id = it->service_id;
+          for (auto& uid : elementUids) {
+            uid.anime_id = anime.id;
+            uids.push_back(uid);
+          }
+          items.push_back(std::move(anime));
+        }
+
+        return callback(std::move(items), std::move(uids), progress);
+      });
 }
 
-Anime parseAnimeElement(QXmlStreamReader& xml) {
-  Anime anime;
+AnimeElement parseAnimeElement(QXmlStreamReader& xml) {
+  AnimeElement element;
+  auto& anime = element.anime;
+  auto extras = std::make_shared<anime::Extras>();
 
   while (xml.readNextStartElement()) {
     if (xml.name() == u"id") {
-      // @TODO: Store ID from current `source`
-      anime.id = XML_ELEMENT.toInt();
+      const auto service = sync::serviceIdFromSlug(xml.attributes().value(u"name").toString());
+      const int id = XML_ELEMENT.toInt();
+      if (service != sync::ServiceId::Unknown) {
+        element.uids.push_back({.service = service, .service_id = id});
+      } else {
+        anime.id = id;
+      }
 
     } else if (xml.name() == u"slug") {
-      anime.slug = XML_ELEMENT.toStdString();
+      extras->slug = XML_ELEMENT.toStdString();
 
     } else if (xml.name() == u"title") {
       anime.titles.romaji = XML_ELEMENT.toStdString();
@@ -98,25 +135,25 @@ Anime parseAnimeElement(QXmlStreamReader& xml) {
       anime.date_finished = FuzzyDate(XML_ELEMENT.toStdString());
 
     } else if (xml.name() == u"image") {
-      anime.image_url = XML_ELEMENT.toStdString();
+      extras->image_url = XML_ELEMENT.toStdString();
 
     } else if (xml.name() == u"trailer_id") {
-      anime.trailer_id = XML_ELEMENT.toStdString();
+      extras->trailer_id = XML_ELEMENT.toStdString();
 
     } else if (xml.name() == u"age_rating") {
       anime.age_rating = static_cast<anime::AgeRating>(XML_ELEMENT.toInt());
 
     } else if (xml.name() == u"genres") {
-      anime.genres = toVector(XML_ELEMENT.split(", ", Qt::SkipEmptyParts));
+      anime.genres = toSymbols(XML_ELEMENT.split(", ", Qt::SkipEmptyParts));
 
     } else if (xml.name() == u"tags") {
-      anime.tags = toVector(XML_ELEMENT.split(", ", Qt::SkipEmptyParts));
+      anime.tags = toSymbols(XML_ELEMENT.split(", ", Qt::SkipEmptyParts));
 
     } else if (xml.name() == u"producers") {
-      anime.producers = toVector(XML_ELEMENT.split(", ", Qt::SkipEmptyParts));
+      anime.producers = toSymbols(XML_ELEMENT.split(", ", Qt::SkipEmptyParts));
 
     } else if (xml.name() == u"studios") {
-      anime.studios = toVector(XML_ELEMENT.split(", ", Qt::SkipEmptyParts));
+      anime.studios = toSymbols(XML_ELEMENT.split(", ", Qt::SkipEmptyParts));
 
     } else if (xml.name() == u"score") {
       anime.score = XML_ELEMENT.toFloat();
@@ -125,7 +162,7 @@ Anime parseAnimeElement(QXmlStreamReader& xml) {
       anime.popularity_rank = XML_ELEMENT.toInt();
 
     } else if (xml.name() == u"synopsis") {
-      anime.synopsis = XML_ELEMENT.toStdString();
+      extras->synopsis = XML_ELEMENT.toStdString();
 
     } else if (xml.name() == u"last_aired_episode") {
       anime.last_aired_episode = XML_ELEMENT.toInt();
@@ -141,7 +178,9 @@ Anime parseAnimeElement(QXmlStreamReader& xml) {
     }
   }
 
-  return anime;
+  anime.extras = std::move(extras);
+
+  return element;
 }
 
 }  // namespace compat::v1
@@ -18,13 +18,27 @@
 
 #pragma once
 
-#include <QList>
+#include <functional>
 #include <string>
+#include <vector>
 
+#include "compat/common.hpp"
 #include "media/anime.hpp"
 
+namespace sync {
+enum class ServiceId;
+}
+
 namespace compat::v1 {
 
-QList<Anime> readAnimeDatabase(const std::string& path);
+// Receives each batch of items along with their ids on every service that v1 knew of
+using AnimeCallback =
+    std::function<bool(std::vector<Anime>&&, std::vector<anime::Uid>&&, const int)>;
+
+// Items are stored with their ids on `service`. Items that only have ids on other services are
+// left out, since they can't be stored with an id of their own, and one of their ids is added to
+// `skipped` instead.
+bool readAnimeDatabase(const std::string& path, const sync::ServiceId service,
+                       const AnimeCallback& callback, std::vector<anime::Uid>& skipped);
 
 }  // namespace compat::v1
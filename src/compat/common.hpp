@@ -18,17 +18,90 @@
 
 #pragma once
 
-#include <QRegularExpression>
+#include <QByteArray>
+#include <QXmlStreamReader>
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <future>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "base/log.hpp"
+#include "base/xml.hpp"
 
 namespace compat::v1 {
 
-// This regex is used to remove the extra root element from v1's XML documents so that they
-// can be read by `QXmlStreamReader` without an "Extra content at end of document" error.
-// See #842 for more information.
-inline void removeMetaElement(QString& str) {
-  static const QRegularExpression meta_element_regex{
-      "<meta>.+</meta>", QRegularExpression::DotMatchesEverythingOption};
-  str.remove(meta_element_regex);
+// Number of elements that are decoded at once by a worker thread
+constexpr size_t kElementBatchSize = 500;
+
+template <typename T>
+using ElementParser = T (*)(QXmlStreamReader&);
+
+// Receives each batch of elements, along with the progress through the file as a percentage.
+// Returning `false` stops reading.
+template <typename T>
+using ElementCallback = std::function<bool(std::vector<T>&&, const int)>;
+
+// Reads the file in chunks on the calling thread, while the elements are decoded in batches on
+// worker threads. Batches are passed to `callback` in document order.
+//
+// Elements are extracted as they are, so the extra root element of v1's XML documents doesn't
+// need to be removed like it does for `QXmlStreamReader` (see #842).
+template <typename T>
+bool readElements(const std::string& path, QByteArrayView element, ElementParser<T> parse,
+                  const ElementCallback<T>& callback) {
+  base::XmlElementScanner scanner;
+
+  if (!scanner.open(QString::fromStdString(path), element)) {
+    LOGE("{}", scanner.file().errorString().toStdString());
+    return false;
+  }
+
+  const auto decode = [parse](std::vector<QByteArray> fragments) {
+    std::vector<T> values;
+    values.reserve(fragments.size());
+    for (const auto& fragment : fragments) {
+      QXmlStreamReader xml{fragment};
+      if (xml.readNextStartElement()) values.emplace_back(parse(xml));
+      if (xml.hasError()) LOGW("{}", xml.errorString().toStdString());
+    }
+    return values;
+  };
+
+  // Bounds the number of batches in memory, while keeping every worker busy
+  const size_t maxPending = std::max(2u, std::thread::hardware_concurrency());
+
+  std::deque<std::pair<std::future<std::vector<T>>, int>> pending;
+
+  const auto deliver = [&pending, &callback]() {
+    auto [values, progress] = std::move(pending.front());
+    pending.pop_front();
+    return callback(values.get(), progress);
+  };
+
+  std::vector<QByteArray> batch;
+  QByteArray fragment;
+
+  for (bool more = true; more;) {
+    more = scanner.readElement(fragment);
+    if (more) batch.emplace_back(std::move(fragment));
+    if (batch.size() < kElementBatchSize && (more || batch.empty())) continue;
+
+    pending.emplace_back(std::async(std::launch::async, decode, std::move(batch)),
+                         more ? scanner.progress() : 100);
+    batch = {};
+
+    if (pending.size() >= maxPending && !deliver()) return false;
+  }
+
+  while (!pending.empty()) {
+    if (!deliver()) return false;
+  }
+
+  return true;
 }
 
 }  // namespace compat::v1
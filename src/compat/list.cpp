@@ -21,7 +21,6 @@
 #include <QXmlStreamReader>
 
 #include "base/log.hpp"
-#include "base/xml.hpp"
 #include "compat/common.hpp"
 
 #define XML_ELEMENT xml.readElementText()
@@ -30,29 +29,8 @@ namespace compat::v1 {
 
 ListEntry parseListEntryElement(QXmlStreamReader& xml);
 
-QList<ListEntry> readListEntries(const std::string& path) {
-  base::XmlFileReader xml;
-
-  if (!xml.open(QString::fromStdString(path), removeMetaElement)) {
-    LOGE("{}", xml.file().errorString().toStdString());
-    return {};
-  }
-
-  if (!xml.readElement(u"library")) {
-    xml.raiseError("Invalid anime list file.");
-  }
-
-  QList<ListEntry> entries;
-
-  while (xml.readElement(u"anime")) {
-    entries.emplace_back(parseListEntryElement(xml));
-  }
-
-  if (xml.hasError()) {
-    LOGE("{}", xml.errorString().toStdString());
-  }
-
-  return entries;
+bool readListEntries(const std::string& path, const ElementCallback<ListEntry>& callback) {
+  return readElements<ListEntry>(path, "anime", parseListEntryElement, callback);
 }
 
 ListEntry parseListEntryElement(QXmlStreamReader& xml) {
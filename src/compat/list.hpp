@@ -18,13 +18,13 @@
 
 #pragma once
 
-#include <QList>
 #include <string>
 
+#include "compat/common.hpp"
 #include "media/anime_list.hpp"
 
 namespace compat::v1 {
 
-QList<ListEntry> readListEntries(const std::string& path);
+bool readListEntries(const std::string& path, const ElementCallback<ListEntry>& callback);
 
 }  // namespace compat::v1
@@ -29,6 +29,7 @@
 #include "gui/utils/painter_state_saver.hpp"
 #include "gui/utils/painters.hpp"
 #include "gui/utils/theme.hpp"
+#include "media/anime_db.hpp"
 #include "media/anime_season.hpp"
 
 namespace gui {
@@ -161,8 +162,9 @@ void ListItemDelegateCards::paint(QPainter* painter, const QStyleOptionViewItem&
     const QStringList lines{
         u"%1 (%2)"_s.arg(formatFuzzyDateRange(item->date_started, item->date_finished))
             .arg(formatStatus(item->status)),
-        joinStrings(item->genres),
-        joinStrings(!item->studios.empty() ? item->studios : item->producers),
+        joinStrings(anime::symbols.names(item->genres)),
+        joinStrings(
+            anime::symbols.names(!item->studios.empty() ? item->studios : item->producers)),
     };
 
     painter->setFont(font);
@@ -181,7 +183,7 @@ void ListItemDelegateCards::paint(QPainter* painter, const QStyleOptionViewItem&
 
   // Synopsis
   {
-    QString synopsis = QString::fromStdString(item->synopsis);
+    QString synopsis = QString::fromStdString(anime::db.extras(item->id)->synopsis);
     synopsis.replace("<br>", "\n");
     removeHtmlTags(synopsis);
     synopsis = synopsis.simplified();
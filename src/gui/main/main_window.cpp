@@ -34,6 +34,7 @@
 #include "gui/utils/theme.hpp"
 #include "gui/utils/tray_icon.hpp"
 #include "gui/utils/widgets.hpp"
+#include "media/anime_db.hpp"
 #include "sync/service.hpp"
 #include "taiga/application.hpp"
 #include "taiga/session.hpp"
@@ -121,6 +122,13 @@ void MainWindow::initActions() {
     });
     loop.exec();
   });
+
+  // Synchronization has to wait until the database is fully loaded
+  if (!anime::db.isReady()) {
+    ui_->actionSynchronize->setEnabled(false);
+    connect(&anime::db, &anime::Database::ready, this,
+            [this]() { ui_->actionSynchronize->setEnabled(true); });
+  }
 }
 
 void MainWindow::initIcons() {
@@ -211,7 +219,16 @@ void MainWindow::initPage(MainWindowPage page) {
 void MainWindow::initStatusbar() {
   ui_->statusbar->setContentsMargins(0, 8, 0, 0);
 
-  ui_->statusbar->showMessage(tr("How are you today?"), 5000);
+  if (anime::db.isReady()) {
+    ui_->statusbar->showMessage(tr("How are you today?"), 5000);
+  } else {
+    ui_->statusbar->showMessage(tr("Loading anime database..."));
+    connect(&anime::db, &anime::Database::migrationProgress, this, [this](const int percent) {
+      ui_->statusbar->showMessage(tr("Migrating anime database... %1%").arg(percent));
+    });
+    connect(&anime::db, &anime::Database::ready, this,
+            [this]() { ui_->statusbar->showMessage(tr("How are you today?"), 5000); });
+  }
 }
 
 void MainWindow::initToolbar() {
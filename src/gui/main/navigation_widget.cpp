@@ -42,6 +42,9 @@ NavigationWidget::NavigationWidget(QWidget* parent) : QTreeWidget(parent) {
 
   refresh();
 
+  connect(&anime::db, &anime::Database::listStatisticsChanged, this,
+          &NavigationWidget::updateCounters);
+
   connect(this, &QTreeWidget::currentItemChanged, this, [this](QTreeWidgetItem* current) {
     if (!current) return;
 
@@ -60,6 +63,7 @@ NavigationWidget::NavigationWidget(QWidget* parent) : QTreeWidget(parent) {
 void NavigationWidget::refresh() {
   setUpdatesEnabled(false);
   clear();
+  m_listStatusItems.clear();
 
   addItem("Home", "home", MainWindowPage::Home);
   addItem("Search", "search", MainWindowPage::Search);
@@ -69,20 +73,15 @@ void NavigationWidget::refresh() {
   listItem->setExpanded(true);
   setItemData(listItem, NavigationItemDataRole::HasChildren, true);
 
-  const auto statusCounts = []() {
-    QMap<anime::list::Status, int> statuses;
-    for (const auto& entry : anime::db.entries()) {
-      statuses[entry.status] += 1;
-    }
-    return statuses;
-  }();
+  const auto& statistics = anime::db.listStatistics();
   for (const auto status : anime::list::kStatuses) {
     auto item = addChildItem(listItem, formatListStatus(status));
     setItemData(item, NavigationItemDataRole::PageIndex, static_cast<int>(MainWindowPage::List));
     setItemData(item, NavigationItemDataRole::IsLastChild,
                 status == anime::list::Status::PlanToWatch);
     setItemData(item, NavigationItemDataRole::ListStatus, static_cast<int>(status));
-    setItemData(item, NavigationItemDataRole::Counter, statusCounts[status]);
+    setItemData(item, NavigationItemDataRole::Counter, statistics.count(status));
+    m_listStatusItems[status] = item;
   }
 
   addItem("History", "history", MainWindowPage::History);
@@ -93,6 +92,15 @@ void NavigationWidget::refresh() {
   setUpdatesEnabled(true);
 }
 
+void NavigationWidget::updateCounters(const anime::list::Statistics& delta) {
+  const auto& statistics = anime::db.listStatistics();
+
+  for (const auto& [status, item] : m_listStatusItems.asKeyValueRange()) {
+    if (delta.count(status) == 0) continue;
+    setItemData(item, NavigationItemDataRole::Counter, statistics.count(status));
+  }
+}
+
 void NavigationWidget::mouseMoveEvent(QMouseEvent* event) {
   auto cursor = Qt::CursorShape::ArrowCursor;
 
@@ -18,10 +18,12 @@
 
 #pragma once
 
+#include <QMap>
 #include <QTreeWidget>
 
 namespace anime::list {
 enum class Status;
+struct Statistics;
 }
 
 namespace gui {
@@ -41,6 +43,7 @@ public:
 
 public slots:
   void refresh();
+  void updateCounters(const anime::list::Statistics& delta);
 
 signals:
   void currentPageChanged(MainWindowPage page);
@@ -54,6 +57,8 @@ private:
   QTreeWidgetItem* addChildItem(QTreeWidgetItem* parent, const QString& text);
   void addSeparator();
   void setItemData(QTreeWidgetItem* item, NavigationItemDataRole role, const QVariant& value);
+
+  QMap<anime::list::Status, QTreeWidgetItem*> m_listStatusItems;
 };
 
 }  // namespace gui
@@ -67,6 +67,15 @@ MediaDialog::MediaDialog(QWidget* parent) : QDialog(parent), ui_(new Ui::MediaDi
   connect(&anime::db, &anime::Database::itemUpdated, this, [this](const int id) {
     if (id != m_anime.id) return;
     m_anime = *anime::db.item(id);
+    m_extras = anime::db.extras(m_anime.id);
+    initTitles();
+    initDetails();
+  });
+
+  connect(&anime::db, &anime::Database::itemsUpdated, this, [this](const QList<int>& ids) {
+    if (!ids.contains(m_anime.id)) return;
+    m_anime = *anime::db.item(m_anime.id);
+    m_extras = anime::db.extras(m_anime.id);
     initTitles();
     initDetails();
   });
@@ -158,6 +167,7 @@ void MediaDialog::show(QWidget* parent, MediaDialogPage page, const Anime& anime
 
 void MediaDialog::setAnime(const Anime& anime, const std::optional<ListEntry> entry) {
   m_anime = anime;
+  m_extras = anime::db.extras(anime.id);
   m_entry = entry;
 
   loadPosterImage();
@@ -165,7 +175,7 @@ void MediaDialog::setAnime(const Anime& anime, const std::optional<ListEntry> en
   initDetails();
   initList();
 
-  if (anime::isStale(anime)) {
+  if (anime::isStale(anime, *m_extras)) {
     sync::fetchAnime(anime.id);
   }
 }
@@ -233,21 +243,22 @@ void MediaDialog::initDetails() {
   ui_->infoLayout->addRow(get_row_title(tr("Score:")), get_row_label(formatScore(m_anime.score)));
   if (!m_anime.genres.empty()) {
     ui_->infoLayout->addRow(get_row_title(tr("Genres:")),
-                            get_row_label(joinStrings(m_anime.genres)));
+                            get_row_label(joinStrings(anime::symbols.names(m_anime.genres))));
   }
   if (!m_anime.tags.empty()) {
-    ui_->infoLayout->addRow(get_row_title(tr("Tags:")), get_row_label(joinStrings(m_anime.tags)));
+    ui_->infoLayout->addRow(get_row_title(tr("Tags:")),
+                            get_row_label(joinStrings(anime::symbols.names(m_anime.tags))));
   }
   if (!m_anime.studios.empty()) {
     ui_->infoLayout->addRow(get_row_title(tr("Studios:")),
-                            get_row_label(joinStrings(m_anime.studios)));
+                            get_row_label(joinStrings(anime::symbols.names(m_anime.studios))));
   }
   if (!m_anime.producers.empty()) {
     ui_->infoLayout->addRow(get_row_title(tr("Producers:")),
-                            get_row_label(joinStrings(m_anime.producers)));
+                            get_row_label(joinStrings(anime::symbols.names(m_anime.producers))));
   }
 
-  const auto synopsis = QString::fromStdString(m_anime.synopsis);
+  const auto synopsis = QString::fromStdString(m_extras->synopsis);
 
   ui_->synopsisHeader->setHidden(synopsis.isEmpty());
 
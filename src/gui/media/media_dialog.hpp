@@ -70,6 +70,7 @@ private:
   Ui::MediaDialog* ui_ = nullptr;
 
   Anime m_anime;
+  std::shared_ptr<const anime::Extras> m_extras;
   std::optional<ListEntry> m_entry;
 };
 
@@ -18,6 +18,7 @@
 
 #include "media_menu.hpp"
 
+#include <QDateTime>
 #include <QDesktopServices>
 #include <QInputDialog>
 #include <QItemSelectionModel>
@@ -25,6 +26,7 @@
 #include <QUrl>
 #include <QUrlQuery>
 #include <ranges>
+#include <vector>
 
 #include "base/string.hpp"
 #include "gui/main/main_window.hpp"
@@ -32,6 +34,7 @@
 #include "gui/utils/format.hpp"
 #include "gui/utils/theme.hpp"
 #include "media/anime.hpp"
+#include "media/anime_db.hpp"
 #include "media/anime_list.hpp"
 #include "media/anime_utils.hpp"
 #include "taiga/settings.hpp"
@@ -74,8 +77,7 @@ bool MediaMenu::isNowPlaying() const {
 }
 
 void MediaMenu::addToList(const anime::list::Status status) const {
-  QMessageBox::information(nullptr, "TODO",
-                           u"Status: %1"_s.arg(formatListStatus(status)));  // @TODO
+  updateEntries([status](ListEntry& entry) { entry.status = status; });
 }
 
 void MediaMenu::editEpisode() const {
@@ -93,7 +95,8 @@ void MediaMenu::editEpisode() const {
   const auto value = QInputDialog::getInt(parentWidget(), tr("Edit Episodes Watched"),
                                           tr("Enter a number:"), initalValue, 0, maxValue, 1, &ok);
   if (!ok) return;
-  QMessageBox::information(nullptr, "TODO", QString::number(value));  // @TODO
+
+  updateEntries([value](ListEntry& entry) { entry.watched_episodes = value; });
 }
 
 void MediaMenu::editNotes() const {
@@ -101,12 +104,12 @@ void MediaMenu::editNotes() const {
   const auto notes =
       QInputDialog::getMultiLineText(parentWidget(), tr("Edit Notes"), tr("Enter notes:"), "", &ok);
   if (!ok) return;
-  QMessageBox::information(nullptr, "TODO", notes);  // @TODO
+
+  updateEntries([&notes](ListEntry& entry) { entry.notes = notes.toStdString(); });
 }
 
 void MediaMenu::editStatus(const anime::list::Status status) const {
-  QMessageBox::information(nullptr, "TODO",
-                           u"Status: %1"_s.arg(formatListStatus(status)));  // @TODO
+  updateEntries([status](ListEntry& entry) { entry.status = status; });
 }
 
 void MediaMenu::playEpisode(int number) const {
@@ -218,8 +221,8 @@ void MediaMenu::searchWikipedia() const {
 
 void MediaMenu::searchYouTube() const {
   for (const auto& item : m_items) {
-    if (!item.trailer_id.empty()) {
-      QUrl url{u"https://youtu.be/%1"_s.arg(QString::fromStdString(item.trailer_id))};
+    if (const auto extras = anime::db.extras(item.id); !extras->trailer_id.empty()) {
+      QUrl url{u"https://youtu.be/%1"_s.arg(QString::fromStdString(extras->trailer_id))};
       QDesktopServices::openUrl(url);
     } else {
       QUrl url{"https://www.youtube.com/results"};
@@ -448,4 +451,22 @@ const ListEntry* MediaMenu::getEntry(int id) const {
   return it != m_entries.end() ? &*it : nullptr;
 }
 
+void MediaMenu::updateEntries(const std::function<void(ListEntry&)>& update) const {
+  std::vector<ListEntry> entries;
+  entries.reserve(m_items.size());
+
+  const auto now = QDateTime::currentSecsSinceEpoch();
+
+  for (const auto& item : m_items) {
+    // Items that are not in the list are added to it as planned, unless the update sets a status
+    auto entry = m_entries.value(
+        item.id, ListEntry{.anime_id = item.id, .status = anime::list::Status::PlanToWatch});
+    update(entry);
+    entry.last_updated = now;
+    entries.push_back(std::move(entry));
+  }
+
+  anime::db.updateEntries(entries);
+}
+
 }  // namespace gui
@@ -21,6 +21,7 @@
 #include <QList>
 #include <QMap>
 #include <QMenu>
+#include <functional>
 
 #include "media/anime.hpp"
 #include "media/anime_list.hpp"
@@ -72,6 +73,8 @@ private:
   bool isNowPlaying() const;
 
   const ListEntry* getEntry(int id) const;
+  // Applies `update` to the entry of each item, adding the items that are not in the list
+  void updateEntries(const std::function<void(ListEntry&)>& update) const;
 
   const QList<Anime> m_items;
   const QMap<int, ListEntry> m_entries;
@@ -24,6 +24,7 @@
 #include <QFont>
 #include <QPalette>
 #include <QSize>
+#include <algorithm>
 
 #include "gui/utils/format.hpp"
 #include "gui/utils/image_provider.hpp"
@@ -33,12 +34,26 @@
 namespace gui {
 
 AnimeListModel::AnimeListModel(QObject* parent) : QAbstractListModel(parent) {
-  beginInsertRows({}, 0, anime::db.items().size());
-  m_ids = anime::db.items().keys();
-  endInsertRows();
+  insertIds(anime::db.items().keys());
+
+  // Items keep arriving in chunks while the database is being loaded in the background
+  connect(&anime::db, &anime::Database::itemsUpdated, this, [this](const QList<int>& ids) {
+    updateIds(ids);
+    insertIds(ids);
+  });
+  connect(&anime::db, &anime::Database::itemUpdated, this, [this](const int id) {
+    updateIds({id});
+    insertIds({id});
+  });
+  connect(&anime::db, &anime::Database::entriesUpdated, this, &AnimeListModel::updateIds);
+  // Rows are items, which remain when their entries are removed from the list
+  connect(&anime::db, &anime::Database::entriesRemoved, this, &AnimeListModel::updateIds);
+  connect(&anime::db, &anime::Database::entryUpdated, this,
+          [this](const int id) { updateIds({id}); });
 
   connect(&imageProvider, &ImageProvider::posterChanged, this, [this](int id) {
-    if (const auto row = m_ids.indexOf(id); row > -1) {
+    if (const auto it = m_rows.constFind(id); it != m_rows.cend()) {
+      const auto row = *it;
       emit dataChanged(index(row), index(row), {static_cast<int>(AnimeListItemDataRole::Poster)});
     }
   });
@@ -254,6 +269,44 @@ Qt::ItemFlags AnimeListModel::flags(const QModelIndex& index) const {
   return QAbstractListModel::flags(index) | Qt::ItemIsEditable;
 }
 
+void AnimeListModel::insertIds(const QList<int>& ids) {
+  QList<int> newIds;
+  for (const auto id : ids) {
+    if (!m_rows.contains(id)) newIds.push_back(id);
+  }
+  if (newIds.isEmpty()) return;
+
+  const auto first = static_cast<int>(m_ids.size());
+  beginInsertRows({}, first, first + newIds.size() - 1);
+  for (const auto id : newIds) {
+    m_rows.insert(id, static_cast<int>(m_ids.size()));
+    m_ids.push_back(id);
+  }
+  endInsertRows();
+}
+
+void AnimeListModel::updateIds(const QList<int>& ids) {
+  QList<int> rows;
+  for (const auto id : ids) {
+    if (const auto it = m_rows.constFind(id); it != m_rows.cend()) rows.push_back(*it);
+  }
+  if (rows.isEmpty()) return;
+
+  std::ranges::sort(rows);
+
+  // Emit a single signal for each contiguous range of rows
+  for (qsizetype i = 0, j = 0; i < rows.size(); i = j) {
+    j = i + 1;
+    while (j < rows.size() && rows[j] == rows[j - 1] + 1) ++j;
+    emit dataChanged(index(rows[i], 0), index(rows[j - 1], NUM_COLUMNS - 1));
+  }
+}
+
+int AnimeListModel::getAnimeId(const QModelIndex& index) const {
+  if (!index.isValid()) return anime::kUnknownId;
+  return m_ids.at(index.row());
+}
+
 const Anime* AnimeListModel::getAnime(const QModelIndex& index) const {
   if (!index.isValid()) return nullptr;
   return anime::db.item(m_ids.at(index.row()));
@@ -19,6 +19,7 @@
 #pragma once
 
 #include <QAbstractListModel>
+#include <QHash>
 #include <QList>
 
 #include "media/anime.hpp"
@@ -63,11 +64,16 @@ public:
   QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
   Qt::ItemFlags flags(const QModelIndex& index) const override;
 
+  int getAnimeId(const QModelIndex& index) const;
   const Anime* getAnime(const QModelIndex& index) const;
   const ListEntry* getListEntry(const QModelIndex& index) const;
 
 private:
+  void insertIds(const QList<int>& ids);
+  void updateIds(const QList<int>& ids);
+
   QList<int> m_ids;
+  QHash<int, int> m_rows;
 };
 
 }  // namespace gui
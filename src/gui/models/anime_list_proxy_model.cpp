@@ -18,12 +18,15 @@
 
 #include "anime_list_proxy_model.hpp"
 
+#include <algorithm>
 #include <ranges>
+#include <utility>
+#include <vector>
 
 #include "gui/models/anime_list_model.hpp"
 #include "media/anime.hpp"
 #include "media/anime_list.hpp"
-#include "media/anime_season.hpp"
+#include "media/anime_db_index.hpp"
 
 namespace {
 
@@ -47,6 +50,28 @@ AnimeListProxyModel::AnimeListProxyModel(QObject* parent) : QSortFilterProxyMode
 
   setSortCaseSensitivity(Qt::CaseInsensitive);
   setSortRole(Qt::UserRole);
+
+  // New and updated items may change the results of the current text filter. Items that are
+  // loaded before the database is ready are matched at once when it is.
+  m_changedIdsTimer.setSingleShot(true);
+  m_changedIdsTimer.setInterval(100);
+  connect(&m_changedIdsTimer, &QTimer::timeout, this,
+          &AnimeListProxyModel::updateChangedTextMatches);
+
+  const auto addChangedIds = [this](const QList<int>& ids) {
+    if (!m_textMatches || !anime::db.isReady()) return;
+    m_changedIds.unite(QSet<int>{ids.cbegin(), ids.cend()});
+    m_changedIdsTimer.start();
+  };
+  connect(&anime::db, &anime::Database::itemUpdated, this,
+          [addChangedIds](const int id) { addChangedIds({id}); });
+  connect(&anime::db, &anime::Database::itemsUpdated, this, addChangedIds);
+
+  connect(&anime::db, &anime::Database::ready, this, [this]() {
+    if (!m_textMatches) return;
+    updateTextMatches();
+    invalidateCandidates();
+  });
 }
 
 const AnimeListProxyModelFilter& AnimeListProxyModel::filters() const {
@@ -55,99 +80,167 @@ const AnimeListProxyModelFilter& AnimeListProxyModel::filters() const {
 
 void AnimeListProxyModel::setFilters(const AnimeListProxyModelFilter& filters) {
   m_filter = filters;
-  invalidateRowsFilter();
+  updateTextMatches();
+  invalidateCandidates();
 }
 
 void AnimeListProxyModel::setYearFilter(std::optional<int> year) {
   m_filter.year = year;
-  invalidateRowsFilter();
+  invalidateCandidates();
 }
 
 void AnimeListProxyModel::setSeasonFilter(std::optional<int> season) {
   m_filter.season = season;
-  invalidateRowsFilter();
+  invalidateCandidates();
 }
 
 void AnimeListProxyModel::setTypeFilter(std::optional<int> type) {
   m_filter.type = type;
-  invalidateRowsFilter();
+  invalidateCandidates();
 }
 
 void AnimeListProxyModel::setStatusFilter(std::optional<int> status) {
   m_filter.status = status;
-  invalidateRowsFilter();
+  invalidateCandidates();
 }
 
 void AnimeListProxyModel::setListStatusFilter(AnimeListStatusFilter filter) {
   m_filter.listStatus = filter;
-  invalidateRowsFilter();
+  invalidateCandidates();
 }
 
 void AnimeListProxyModel::setTextFilter(const QString& text) {
   m_filter.text = text;
+  updateTextMatches();
+  invalidateCandidates();
+}
+
+void AnimeListProxyModel::setSearchScope(anime::SearchScope scope) {
+  m_searchScope = scope;
+  updateTextMatches();
+  invalidateCandidates();
+}
+
+void AnimeListProxyModel::updateTextMatches() {
+  m_changedIds.clear();
+  m_changedIdsTimer.stop();
+
+  // Queries that are too short for the full-text index are matched row by row instead
+  if (m_filter.text.size() < 3) {
+    m_textMatches.reset();
+    return;
+  }
+
+  const auto ids = anime::db.search(m_filter.text, -1, m_searchScope);
+  m_textMatches = QSet<int>{ids.cbegin(), ids.cend()};
+}
+
+void AnimeListProxyModel::updateChangedTextMatches() {
+  // Many changes at once are cheaper to match with a single query over the whole index
+  constexpr qsizetype kMaxChangedIds = 1000;
+
+  if (!m_textMatches) return;
+
+  if (m_changedIds.size() > kMaxChangedIds) {
+    updateTextMatches();
+  } else {
+    const auto ids = std::exchange(m_changedIds, {}) | std::ranges::to<std::vector>();
+    for (const int id : ids) m_textMatches->remove(id);
+    for (const int id : anime::db.search(m_filter.text, ids, m_searchScope)) {
+      m_textMatches->insert(id);
+    }
+  }
+
+  invalidateCandidates();
+}
+
+void AnimeListProxyModel::invalidateCandidates() {
+  m_candidatesGeneration.reset();
   invalidateRowsFilter();
 }
 
-bool AnimeListProxyModel::filterAcceptsRow(int row, const QModelIndex& parent) const {
-  const auto model = static_cast<AnimeListModel*>(sourceModel());
-  if (!model) return false;
-  const auto index = model->index(row, 0, parent);
-  const auto anime = getAnime(index);
-  if (!anime) return false;
-  const auto entry = getListEntry(index);
+void AnimeListProxyModel::updateCandidates() const {
+  const auto& index = anime::db.index();
 
-  static const auto contains = [](const std::string& str, const QStringView view) {
-    return QString::fromStdString(str).contains(view, Qt::CaseInsensitive);
-  };
+  if (m_candidatesGeneration == index.generation()) return;
+  m_candidatesGeneration = index.generation();
 
-  static const auto list_contains = [](const std::vector<std::string>& list,
-                                       const QStringView view) {
-    return std::ranges::any_of(list,
-                               [view](const std::string& str) { return contains(str, view); });
-  };
+  std::vector<const QSet<int>*> sets;
 
-  // Year
   if (m_filter.year) {
-    if (anime->date_started.year() != *m_filter.year) return false;
+    sets.push_back(&index.itemsByYear(*m_filter.year));
   }
-
-  // Season
   if (m_filter.season) {
-    const anime::Season season{anime->date_started};
-    if (static_cast<int>(season.name) != *m_filter.season) return false;
+    sets.push_back(&index.itemsBySeason(static_cast<anime::SeasonName>(*m_filter.season)));
   }
-
-  // Type
   if (m_filter.type) {
-    if (static_cast<int>(anime->type) != *m_filter.type) return false;
+    sets.push_back(&index.itemsByType(static_cast<anime::Type>(*m_filter.type)));
   }
-
-  // Status
   if (m_filter.status) {
-    if (static_cast<int>(anime->status) != *m_filter.status) return false;
+    sets.push_back(&index.itemsByStatus(static_cast<anime::Status>(*m_filter.status)));
   }
-
-  // List status
   if (m_filter.listStatus.status) {
-    const auto status = entry ? entry->status : anime::list::Status::NotInList;
-    if (m_filter.listStatus.anyStatus) {
-      if (status == anime::list::Status::NotInList) return false;
-    } else {
-      if (static_cast<int>(status) != *m_filter.listStatus.status) return false;
-    }
+    sets.push_back(m_filter.listStatus.anyStatus
+                       ? &index.itemsInList()
+                       : &index.itemsByListStatus(
+                             static_cast<anime::list::Status>(*m_filter.listStatus.status)));
+  }
+  if (m_textMatches) {
+    sets.push_back(&*m_textMatches);
   }
 
-  // Titles
-  if (!m_filter.text.isEmpty()) {
-    if (!contains(anime->titles.romaji, m_filter.text) &&
-        !contains(anime->titles.english, m_filter.text) &&
-        !contains(anime->titles.japanese, m_filter.text) &&
-        !list_contains(anime->titles.synonyms, m_filter.text)) {
-      return false;
+  if (sets.empty()) {
+    m_candidates.reset();
+    return;
+  }
+
+  // Starting from the smallest set keeps the intersection proportional to the result
+  std::ranges::sort(sets, {}, &QSet<int>::size);
+
+  QSet<int> candidates;
+  for (const int id : *sets.front()) {
+    if (std::ranges::all_of(sets | std::views::drop(1),
+                            [id](const QSet<int>* set) { return set->contains(id); })) {
+      candidates.insert(id);
     }
   }
 
-  return true;
+  m_candidates = std::move(candidates);
+}
+
+bool AnimeListProxyModel::filterAcceptsRow(int row, const QModelIndex& parent) const {
+  const auto model = static_cast<AnimeListModel*>(sourceModel());
+  if (!model) return false;
+  const auto index = model->index(row, 0, parent);
+
+  // The index is updated before the model is notified of changes, so the candidates are always
+  // rebuilt before any row is filtered against a stale set
+  updateCandidates();
+
+  if (m_candidates) {
+    if (!m_candidates->contains(model->getAnimeId(index))) return false;
+  }
+
+  // Queries that are too short for the full-text index are matched row by row
+  if (m_textMatches || m_filter.text.isEmpty()) return true;
+
+  const auto anime = model->getAnime(index);
+  if (!anime) return false;
+
+  static const auto contains = [](const std::string& str, const QStringView view) {
+    return QString::fromStdString(str).contains(view, Qt::CaseInsensitive);
+  };
+
+  static const auto list_contains = [](const std::vector<std::string>& list,
+                                       const QStringView view) {
+    return std::ranges::any_of(list,
+                               [view](const std::string& str) { return contains(str, view); });
+  };
+
+  return contains(anime->titles.romaji, m_filter.text) ||
+         contains(anime->titles.english, m_filter.text) ||
+         contains(anime->titles.japanese, m_filter.text) ||
+         list_contains(anime->titles.synonyms, m_filter.text);
 }
 
 bool AnimeListProxyModel::lessThan(const QModelIndex& lhs, const QModelIndex& rhs) const {
@@ -18,9 +18,13 @@
 
 #pragma once
 
+#include <QSet>
 #include <QSortFilterProxyModel>
+#include <QTimer>
 #include <optional>
 
+#include "media/anime_db.hpp"
+
 namespace gui {
 
 struct AnimeListStatusFilter {
@@ -55,12 +59,29 @@ public:
   void setListStatusFilter(AnimeListStatusFilter filter);
   void setTextFilter(const QString& text);
 
+  void setSearchScope(anime::SearchScope scope);
+
 protected:
   bool filterAcceptsRow(int row, const QModelIndex& parent) const override;
   bool lessThan(const QModelIndex& lhs, const QModelIndex& rhs) const override;
 
 private:
+  void updateTextMatches();
+  void updateChangedTextMatches();
+  void invalidateCandidates();
+  void updateCandidates() const;
+
   AnimeListProxyModelFilter m_filter;
+  anime::SearchScope m_searchScope = anime::SearchScope::Titles;
+  std::optional<QSet<int>> m_textMatches;
+
+  // Changes to items are collected and matched against the text filter at once
+  QSet<int> m_changedIds;
+  QTimer m_changedIdsTimer;
+
+  // Items that pass every indexed filter, derived from the database index
+  mutable std::optional<QSet<int>> m_candidates;
+  mutable std::optional<size_t> m_candidatesGeneration;
 };
 
 }  // namespace gui
@@ -43,6 +43,17 @@ LibraryModel::LibraryModel(QObject* parent) : QFileSystemModel(parent) {
   setNameFilterDisables(true);
 
   connect(this, &QFileSystemModel::directoryLoaded, this, &LibraryModel::parseDirectory);
+
+  // Files that were parsed before the database was ready could not be identified
+  connect(&anime::db, &anime::Database::ready, this, [this]() {
+    const auto paths = m_parsed.keys();
+    m_parsed.clear();
+    for (const auto& path : paths) {
+      parseFileInfo(QFileInfo{path});
+      const auto first = index(path, COLUMN_ANIME);
+      emit dataChanged(first, first.siblingAtColumn(COLUMN_EPISODE));
+    }
+  });
 }
 
 int LibraryModel::columnCount(const QModelIndex&) const {
@@ -26,6 +26,7 @@
 #include "gui/utils/format.hpp"
 #include "gui/utils/theme.hpp"
 #include "media/anime.hpp"
+#include "media/anime_db.hpp"
 #include "media/anime_season.hpp"
 #include "taiga/session.hpp"
 
@@ -40,6 +41,7 @@ SearchWidget::SearchWidget(QWidget* parent)
       m_comboSeason(new ComboBox(this)),
       m_comboType(new ComboBox(this)),
       m_comboStatus(new ComboBox(this)) {
+  m_proxyModel->setSearchScope(anime::SearchScope::TitlesAndSynopsis);
   m_proxyModel->sort(taiga::session.searchListSortColumn(), taiga::session.searchListSortOrder());
   m_proxyModel->setFilters(taiga::session.searchListFilters());
 
@@ -32,11 +32,12 @@
 namespace gui {
 
 void ImageProvider::fetchPoster(const int id) {
-  const auto item = anime::db.item(id);
+  if (!anime::db.item(id)) return;
 
-  if (!item || item->image_url.empty()) return;
+  const auto extras = anime::db.extras(id);
+  if (extras->image_url.empty()) return;
 
-  const auto url = QString::fromStdString(item->image_url);
+  const auto url = QString::fromStdString(extras->image_url);
   const auto reply = taiga::network()->get(QNetworkRequest{url});
 
   connect(reply, &QNetworkReply::finished, this, [this, id, reply]() {
@@ -19,10 +19,16 @@
 #pragma once
 
 #include <array>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "base/chrono.hpp"
+#include "base/symbol_table.hpp"
+
+namespace sync {
+enum class ServiceId;
+}
 
 namespace anime {
 
@@ -79,6 +85,12 @@ constexpr int kUnknownEpisodeLength = -1;
 constexpr int kUnknownId = 0;
 constexpr double kUnknownScore = 0.0;
 
+using Symbol = base::SymbolTable::id_t;
+
+// Genres, producers, studios and tags are shared by many items, so they are interned here and
+// stored as ids in `Details`.
+inline base::SymbolTable symbols;
+
 struct Titles {
   std::string romaji;
   std::string english;
@@ -86,10 +98,25 @@ struct Titles {
   std::vector<std::string> synonyms;
 };
 
+// Fields that are only needed when an item is shown in detail. These are kept out of the
+// resident items and loaded from the database on demand, see `Database::extras()`.
+struct Extras {
+  std::string image_url;
+  std::string slug;
+  std::string synopsis;
+  std::string trailer_id;
+};
+
+// Maps the id of an item on a service to the id that it's stored with. These are kept out of the
+// items, see `Database::resolveIds()`.
+struct Uid {
+  sync::ServiceId service{};
+  int service_id = kUnknownId;
+  int anime_id = kUnknownId;
+};
+
 struct Details {
   int id = kUnknownId;
-  // std::map<sync::ServiceId, std::string> uids;
-  // sync::ServiceId source = sync::ServiceId::Unknown;
   std::time_t last_modified = 0;
   int episode_count = kUnknownEpisodeCount;
   int episode_length = kUnknownEpisodeLength;
@@ -100,15 +127,12 @@ struct Details {
   FuzzyDate date_finished;
   float score = 0.0f;
   int popularity_rank = 0;
-  std::string image_url;
-  std::string slug;
-  std::string synopsis;
-  std::string trailer_id;
+  std::shared_ptr<const Extras> extras;  // only set on items that are about to be written
   Titles titles;
-  std::vector<std::string> genres;
-  std::vector<std::string> producers;
-  std::vector<std::string> studios;
-  std::vector<std::string> tags;
+  std::vector<Symbol> genres;
+  std::vector<Symbol> producers;
+  std::vector<Symbol> studios;
+  std::vector<Symbol> tags;
   int last_aired_episode = 0;
   std::time_t next_episode_time = 0;
 };
@@ -18,309 +18,1327 @@
 
 #include "anime_db.hpp"
 
+#include <QElapsedTimer>
 #include <QFile>
 #include <QSqlError>
 #include <QSqlQuery>
 #include <QSqlRecord>
 #include <QSqlResult>
+#include <QThread>
+#include <QTimer>
+#include <algorithm>
+#include <array>
 #include <format>
+#include <ranges>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "base/file.hpp"
+#include "base/log.hpp"
 #include "base/string.hpp"
 #include "compat/anime.hpp"
 #include "compat/list.hpp"
+#include "sync/service.hpp"
 #include "taiga/accounts.hpp"
 #include "taiga/path.hpp"
 #include "taiga/settings.hpp"
 #include "taiga/version.hpp"
 
+namespace {
+
+// Version of the database schema, as stored in the `meta` table. Each version is reached from
+// the previous one by running `:/sql/migrations/<version>.sql` in its own transaction. Version 0
+// is an empty database.
+//
+// SQLite can't change the type of a column in place, so steps that need to do so must rebuild
+// the table (create a new table, copy the rows, drop the old table and rename the new one).
+constexpr int kSchemaVersion = 7;
+
+struct Relation {
+  QLatin1StringView table;
+  std::vector<anime::Symbol> Anime::* member;
+};
+
+// Lists that are stored in `<table>` and linked to items through `anime_<table>`
+const std::array<Relation, 4> kRelations{{
+    {"genre"_L1, &Anime::genres},
+    {"producer"_L1, &Anime::producers},
+    {"studio"_L1, &Anime::studios},
+    {"tag"_L1, &Anime::tags},
+}};
+
+// Column ordinals of `:/sql/selectAnime.sql`, so that rows can be decoded without looking up
+// each field by its name
+enum AnimeColumn {
+  kAnimeId,
+  kAnimeTitle,
+  kAnimeEnglish,
+  kAnimeJapanese,
+  kAnimeType,
+  kAnimeStatus,
+  kAnimeEpisodeCount,
+  kAnimeEpisodeLength,
+  kAnimeDateStart,
+  kAnimeDateEnd,
+  kAnimeAgeRating,
+  kAnimeScore,
+  kAnimePopularity,
+  kAnimeLastAiredEpisode,
+  kAnimeNextEpisodeTime,
+  kAnimeModified,
+};
+
+// Column ordinals of `:/sql/selectAnimeList.sql`
+enum AnimeListColumn {
+  kListId,
+  kListMediaId,
+  kListProgress,
+  kListDateStart,
+  kListDateEnd,
+  kListScore,
+  kListStatus,
+  kListPrivate,
+  kListRewatchedTimes,
+  kListRewatching,
+  kListRewatchingEp,
+  kListNotes,
+  kListLastUpdated,
+};
+
+std::string textValue(const QSqlQuery& q, const int column) {
+  return toStdString(q.value(column).toString());
+}
+
+// Ids are bound as a single JSON array, so that any number of them can be looked up with the same
+// statement
+QString jsonArray(std::span<const int> ids) {
+  QString array{u'['};
+  for (const int id : ids) {
+    if (array.size() > 1) array += u',';
+    array += QString::number(id);
+  }
+  array += u']';
+  return array;
+}
+
+// Quotes the query as a single phrase, so that its syntax isn't interpreted
+QString searchPhrase(const QString& query, const anime::SearchScope scope) {
+  const auto phrase = u"\"%1\""_s.arg(QString{query}.replace(u"\""_s, u"\"\""_s));
+  if (scope == anime::SearchScope::Titles) {
+    return u"{title english japanese synonyms} : %1"_s.arg(phrase);
+  }
+  return phrase;
+}
+
+// Formats ids as `<service>:<id>`, so that the items can be looked up on their services
+std::string formatUids(std::span<const anime::Uid> uids) {
+  std::string text;
+  for (const auto& uid : uids) {
+    if (!text.empty()) text += ", ";
+    text += std::format("{}:{}", sync::serviceSlug(uid.service).toStdString(), uid.service_id);
+  }
+  return text;
+}
+
+// Column ordinals of `:/sql/selectAnimeExtras.sql`
+enum AnimeExtrasColumn {
+  kExtrasImage,
+  kExtrasSlug,
+  kExtrasSynopsis,
+  kExtrasTrailerId,
+};
+
+// Delay between the first of a series of list entry updates and writing them to the disk
+constexpr int kFlushDelayMs = 500;
+
+// Number of extras that are kept in memory, enough for a screenful of cards plus a few dialogs
+constexpr size_t kExtrasCacheSize = 256;
+
+// Number of rows that are handed over to the main thread at once while loading
+constexpr size_t kLoadChunkSize = 1000;
+
+constexpr auto kLoaderConnectionName = "loader";
+
+// Walks the rows of an `(anime_id, value)` or `(anime_id, symbol_id, name)` query that is
+// ordered by `anime_id`, in step with the items that are being read, so that relations don't
+// have to be buffered in memory.
+class RelationReader final {
+public:
+  RelationReader(const QSqlDatabase& db, const QString& query) : q_{db} {
+    q_.setForwardOnly(true);
+    valid_ = q_.exec(query) && q_.next();
+  }
+
+  void read(const int id, std::vector<std::string>& values) {
+    while (valid_ && q_.value(0).toInt() < id) valid_ = q_.next();
+    while (valid_ && q_.value(0).toInt() == id) {
+      values.push_back(textValue(q_, 1));
+      valid_ = q_.next();
+    }
+  }
+
+  void read(const int id, std::vector<anime::Symbol>& values) {
+    while (valid_ && q_.value(0).toInt() < id) valid_ = q_.next();
+    while (valid_ && q_.value(0).toInt() == id) {
+      values.push_back(symbol(q_.value(1).toInt()));
+      valid_ = q_.next();
+    }
+  }
+
+private:
+  // Each name is interned once, the first time its row id is seen
+  anime::Symbol symbol(const int rowId) {
+    if (const auto it = symbols_.find(rowId); it != symbols_.end()) return it->second;
+    return symbols_.emplace(rowId, anime::symbols.intern(textValue(q_, 2))).first->second;
+  }
+
+  QSqlQuery q_;
+  bool valid_ = false;
+  std::unordered_map<int, anime::Symbol> symbols_;
+};
+
+}  // namespace
+
 namespace anime {
 
-Database::Database() : QObject{} {}
+Database::Database()
+    : QObject{},
+      statements_{[this](const QString& name) { return sql(name); }},
+      extras_{kExtrasCacheSize},
+      snapshot_{std::make_shared<const Snapshot>()} {}
 
 void Database::init() {
+  const bool exists = QFile::exists(fileName());
+
+  // Must be taken before the database is opened, which may create a write-ahead log
+  const auto stamp = cache::databaseStamp(fileName());
+
   db_ = QSqlDatabase::addDatabase("QSQLITE");
   db_.setDatabaseName(fileName());
 
-  if (!QFile::exists(fileName())) {
-    createTables();
-    migrateItemsFromV1();
-    migrateListEntriesFromV1();
+  // The connection is kept open for the lifetime of the application, so that we don't pay for
+  // opening the file and re-reading the schema on every write.
+  if (!db_.open()) {
+    LOGE("{}", db_.lastError().text().toStdString());
     return;
   }
 
-  readItems();
-  readEntries();
+  setPragmas();
+  statements_.setDatabase(db_);
+
+  migrateSchema();
+
+  startWriter();
+
+  if (!exists) {
+    migrateFromV1();
+    return;
+  }
+
+  if (stamp && loadCache(*stamp)) {
+    setReady();
+    return;
+  }
+
+  load();
+}
+
+void Database::close() {
+  if (loader_) {
+    loader_->requestInterruption();
+    loader_->wait();
+  }
+
+  // An unfinished migration is discarded along with the database, so that it starts over the
+  // next time
+  const bool discard = migrating_;
+  if (discard) {
+    db_.rollback();
+    migrating_ = false;
+    pendingEntries_.clear();
+    pendingTombstones_.clear();
+  }
+
+  stopWriter();
+
+  LOGD("Statement cache: {} hits, {} misses", statements_.stats().hits,
+       statements_.stats().misses);
+
+  statements_.clear();
+
+  if (db_.isOpen()) db_.close();
+
+  if (discard) {
+    QFile::remove(fileName());
+    return;
+  }
+
+  // Written once all connections are closed, so that the changes have been checkpointed into the
+  // database file and its stamp is final.
+  if (ready_) writeCache();
+}
+
+bool Database::isReady() const {
+  return ready_;
 }
 
 const Anime* Database::item(const int id) const {
-  const auto it = items_.find(id);
-  return it != items_.end() ? &(*it) : nullptr;
+  return items_.find(id);
 }
 
 const ListEntry* Database::entry(const int id) const {
-  const auto it = entries_.find(id);
-  return it != entries_.end() ? &(*it) : nullptr;
+  return entries_.find(id);
+}
+
+std::shared_ptr<const Extras> Database::extras(const int id) {
+  if (const auto extras = extras_.find(id)) return *extras;
+
+  auto extras = std::make_shared<Extras>();
+
+  if (const auto q = statements_.get("selectAnimeExtras")) {
+    q->bindValue(":id", id);
+    if (q->exec() && q->next()) {
+      extras->image_url = textValue(*q, kExtrasImage);
+      extras->slug = textValue(*q, kExtrasSlug);
+      extras->synopsis = textValue(*q, kExtrasSynopsis);
+      extras->trailer_id = textValue(*q, kExtrasTrailerId);
+    }
+    q->finish();
+  }
+
+  extras_.insert(id, extras);
+
+  return extras;
+}
+
+QList<int> Database::search(const QString& query, const int limit, const SearchScope scope) {
+  // The trigram tokenizer can't match anything shorter than three characters
+  if (query.size() < 3 || !db_.isOpen()) return {};
+
+  const auto q = statements_.get("searchAnime");
+  if (!q) return {};
+
+  q->bindValue(":query", searchPhrase(query, scope));
+  q->bindValue(":limit", limit);
+
+  QList<int> ids;
+
+  if (!q->exec()) {
+    LOGW("{}", q->lastError().text().toStdString());
+    return ids;
+  }
+
+  while (q->next()) {
+    ids.push_back(q->value(0).toInt());
+  }
+
+  return ids;
+}
+
+QList<int> Database::search(const QString& query, std::span<const int> ids,
+                            const SearchScope scope) {
+  if (query.size() < 3 || ids.empty() || !db_.isOpen()) return {};
+
+  const auto q = statements_.get("searchAnimeIds");
+  if (!q) return {};
+
+  q->bindValue(":query", searchPhrase(query, scope));
+  q->bindValue(":ids", jsonArray(ids));
+
+  QList<int> matches;
+
+  if (!q->exec()) {
+    LOGW("{}", q->lastError().text().toStdString());
+    return matches;
+  }
+
+  while (q->next()) {
+    matches.push_back(q->value(0).toInt());
+  }
+
+  return matches;
+}
+
+std::shared_ptr<const Snapshot> Database::snapshot() const {
+  return snapshot_.load();
+}
+
+list::Statistics Database::entryStatistics(const int id) const {
+  list::Statistics statistics;
+
+  const auto entry = entries_.find(id);
+  if (!entry) return statistics;
+
+  // Statuses are read from the disk and from services as plain integers, and are not validated
+  if (const auto status = static_cast<size_t>(entry->status); status < statistics.counts.size()) {
+    statistics.counts[status] = 1;
+  } else {
+    LOGW("Invalid list status {} of item {}.", status, id);
+  }
+
+  // Completed rewatches are counted in full, which requires the item to be known
+  const auto item = items_.find(id);
+  const int episodeCount = item ? std::max(item->episode_count, 0) : 0;
+  const int episodeLength = item ? std::max(item->episode_length, 0) : 0;
+
+  statistics.episodes = entry->watched_episodes + entry->rewatched_times * episodeCount;
+  statistics.minutes = statistics.episodes * episodeLength;
+
+  return statistics;
+}
+
+void Database::applyStatistics(const list::Statistics& delta) {
+  if (delta == list::Statistics{}) return;
+
+  statistics_ += delta;
+
+  emit listStatisticsChanged(delta);
 }
 
-const QMap<int, Anime>& Database::items() const {
+void Database::publishSnapshot(std::span<const int> itemIds, std::span<const int> entryIds,
+                               std::span<const int> removedEntryIds) {
+  // Loading adds items in many small chunks, each of which would copy most of the snapshot.
+  // A complete snapshot is published once the database is ready instead.
+  if (!ready_) return;
+
+  const auto current = snapshot_.load();
+
+  // Values are copied from the stores, where items have already been stripped of their extras
+  const auto storedItems = [this](const int id) -> const Anime& { return *items_.find(id); };
+  const auto storedEntries = [this](const int id) -> const ListEntry& {
+    return *entries_.find(id);
+  };
+
+  snapshot_.store(std::make_shared<const Snapshot>(
+      current->items().with(itemIds | std::views::transform(storedItems)),
+      current->entries()
+          .with(entryIds | std::views::transform(storedEntries))
+          .without(removedEntryIds)));
+}
+
+const base::FlatStore<Anime>& Database::items() const {
   return items_;
 }
 
-const QMap<int, ListEntry>& Database::entries() const {
+const base::FlatStore<ListEntry>& Database::entries() const {
   return entries_;
 }
 
-void Database::updateItem(const Anime& item) {
-  if (!db_.open()) return;
-
-  QSqlQuery q{db_};
-  if (!q.prepare(sql("insertAnime"))) return;
-  bindItemToQuery(item, q);
-  q.exec();
+const DatabaseIndex& Database::index() const {
+  return index_;
+}
 
-  db_.close();
+const list::Statistics& Database::listStatistics() const {
+  return statistics_;
+}
 
-  items_[item.id] = item;
+void Database::updateItem(const Anime& item) {
+  if (!writeItems({&item, 1})) return;
 
   emit itemUpdated(item.id);
 }
 
 void Database::updateEntry(const ListEntry& entry) {
-  if (!db_.open()) return;
+  queueEntries({&entry, 1});
 
-  QSqlQuery q{db_};
-  if (!q.prepare(sql("insertAnimeList"))) return;
-  bindEntryToQuery(entry, q);
-  q.exec();
+  emit entryUpdated(entry.anime_id);
+}
+
+void Database::updateItems(std::span<const Anime> items) {
+  if (items.empty() || !writeItems(items)) return;
 
-  db_.close();
+  emit itemsUpdated(items | std::views::transform(&Anime::id) | std::ranges::to<QList>());
+}
 
-  entries_[entry.anime_id] = entry;
+void Database::removeEntry(const int id) {
+  removeEntries({&id, 1});
+}
 
-  emit entryUpdated(entry.anime_id);
+void Database::removeEntries(std::span<const int> ids) {
+  auto removed = ids | std::views::filter([this](const int id) { return entries_.contains(id); }) |
+                 std::ranges::to<QList>();
+
+  // The same id may be passed more than once, but it can only be removed once
+  std::ranges::sort(removed);
+  removed.erase(std::ranges::unique(removed).begin(), removed.end());
+
+  if (removed.isEmpty()) return;
+
+  list::Statistics delta;
+  for (const int id : removed) {
+    delta -= entryStatistics(id);
+  }
+
+  queueTombstones({removed.constData(), static_cast<size_t>(removed.size())});
+
+  applyStatistics(delta);
+
+  emit entriesRemoved(removed);
+}
+
+std::optional<std::time_t> Database::entryRemovedAt(const int id) {
+  if (const auto it = pendingTombstones_.constFind(id); it != pendingTombstones_.cend()) {
+    return it->removed_at;
+  }
+
+  // An entry that is in the list again is no longer removed, whatever the database says
+  if (entries_.contains(id)) return std::nullopt;
+
+  if (const auto it = writingTombstones_.constFind(id); it != writingTombstones_.cend()) {
+    return it->removed_at;
+  }
+
+  std::optional<std::time_t> removedAt;
+
+  if (const auto q = statements_.get("selectAnimeListTombstone")) {
+    q->bindValue(":media_id", id);
+    if (q->exec() && q->next()) removedAt = q->value(0).toLongLong();
+    q->finish();
+  }
+
+  return removedAt;
+}
+
+void Database::updateUids(std::span<const Uid> uids) {
+  if (uids.empty() || !db_.isOpen()) return;
+
+  const auto q = statements_.get("insertAnimeIds");
+  if (!q) return;
+
+  // During the migration, rows are written as part of its transaction
+  const bool transaction = !migrating_;
+
+  if (transaction) db_.transaction();
+
+  for (const auto& uid : uids) {
+    if (uid.service == sync::ServiceId::Unknown) continue;
+    if (uid.service_id == kUnknownId || uid.anime_id == kUnknownId) continue;
+    q->bindValue(":service", sync::serviceSlug(uid.service));
+    q->bindValue(":service_id", uid.service_id);
+    q->bindValue(":anime_id", uid.anime_id);
+    if (!q->exec()) LOGW("{}", q->lastError().text().toStdString());
+  }
+
+  if (transaction) db_.commit();
+}
+
+QHash<int, int> Database::resolveIds(const sync::ServiceId service,
+                                     std::span<const int> serviceIds) {
+  return selectIds("selectAnimeIds", service, serviceIds);
+}
+
+QHash<int, int> Database::serviceIds(const sync::ServiceId service,
+                                     std::span<const int> animeIds) {
+  return selectIds("selectServiceIds", service, animeIds);
+}
+
+QHash<int, int> Database::selectIds(const QString& name, const sync::ServiceId service,
+                                    std::span<const int> ids) {
+  QHash<int, int> result;
+
+  if (ids.empty() || !db_.isOpen()) return result;
+
+  const auto q = statements_.get(name);
+  if (!q) return result;
+
+  q->bindValue(":service", sync::serviceSlug(service));
+  q->bindValue(":ids", jsonArray(ids));
+
+  if (!q->exec()) {
+    LOGW("{}", q->lastError().text().toStdString());
+    return result;
+  }
+
+  result.reserve(static_cast<qsizetype>(ids.size()));
+  while (q->next()) {
+    result.insert(q->value(0).toInt(), q->value(1).toInt());
+  }
+  q->finish();
+
+  return result;
+}
+
+void Database::updateEntries(std::span<const ListEntry> entries) {
+  if (entries.empty()) return;
+
+  queueEntries(entries);
+
+  emit entriesUpdated(entries | std::views::transform(&ListEntry::anime_id) |
+                      std::ranges::to<QList>());
 }
 
 QString Database::fileName() const {
   return u"%1/media.sqlite"_s.arg(QString::fromStdString(taiga::get_data_path()));
 }
 
+QString Database::cacheFileName() const {
+  return u"%1/media.cache"_s.arg(QString::fromStdString(taiga::get_data_path()));
+}
+
+const base::SqlStatementCache::Stats& Database::statementCacheStats() const {
+  return statements_.stats();
+}
+
 QString Database::sql(const QString& name) const {
-  return base::readFile(u":/sql/%1.sql"_s.arg(name));
+  const std::lock_guard lock{sql_mutex_};
+
+  if (const auto it = sql_.constFind(name); it != sql_.cend()) return *it;
+
+  return sql_.insert(name, base::readFile(u":/sql/%1.sql"_s.arg(name))).value();
+}
+
+void Database::setPragmas() {
+  // clang-format off
+  static const QStringList pragmas{
+      "PRAGMA journal_mode = WAL",      // readers don't block the writer and vice versa
+      "PRAGMA synchronous = NORMAL",    // safe in WAL mode, fsync only at checkpoints
+      "PRAGMA cache_size = -16384",     // 16 MiB page cache
+      "PRAGMA mmap_size = 268435456",   // 256 MiB
+      "PRAGMA temp_store = MEMORY",
+      "PRAGMA busy_timeout = 5000",     // wait for the list writer rather than fail
+  };
+  // clang-format on
+
+  QSqlQuery q{db_};
+
+  for (const auto& pragma : pragmas) {
+    if (!q.exec(pragma)) LOGW("{}", q.lastError().text().toStdString());
+  }
 }
 
-void Database::createTables() {
-  if (!db_.open()) return;
+int Database::schemaVersion() {
+  if (!db_.tables().contains("meta")) return 0;
 
-  const auto tables = db_.tables();
+  QSqlQuery q{db_};
 
-  db_.transaction();
+  if (!q.exec("SELECT value FROM meta WHERE name = 'schema_version'") || !q.next()) {
+    return 1;  // databases created before the schema was versioned
+  }
+
+  return q.value(0).toInt();
+}
+
+void Database::setMetaValue(const QString& name, const QVariant& value) {
+  QSqlQuery q{db_};
+
+  q.prepare("DELETE FROM meta WHERE name = :name");
+  q.bindValue(":name", name);
+  q.exec();
+
+  q.prepare("INSERT INTO meta(name, value) VALUES(:name, :value)");
+  q.bindValue(":name", name);
+  q.bindValue(":value", value);
+  q.exec();
+}
 
-  if (!tables.contains("meta")) {
-    QSqlQuery q{db_};
-    q.exec(sql("createMeta"));
-    q.prepare("INSERT INTO meta(name, value) VALUES(:name, :value)");
-    q.bindValue(":name", "version");
-    q.bindValue(":value", QString::fromStdString(taiga::version().to_string()));
-    q.exec();
+void Database::migrateSchema() {
+  if (!db_.isOpen()) return;
+
+  const int version = schemaVersion();
+
+  if (version >= kSchemaVersion) return;
+
+  if (version > 0) {
+    LOGI("Migrating database schema from version {} (Taiga {}) to {}.", version,
+         currentVersion().toStdString(), kSchemaVersion);
   }
 
-  if (!tables.contains("anime")) {
-    QSqlQuery q{db_};
-    q.exec(sql("createAnime"));
+  for (int step = version + 1; step <= kSchemaVersion; ++step) {
+    if (!migrateSchemaTo(step)) return;
   }
 
-  if (!tables.contains("anime_list")) {
-    QSqlQuery q{db_};
-    q.exec(sql("createAnimeList"));
+  // Let the query planner take new indexes into account
+  QSqlQuery q{db_};
+  q.exec("PRAGMA optimize");
+
+  setMetaValue("version", QString::fromStdString(taiga::version().to_string()));
+}
+
+bool Database::migrateSchemaTo(const int version) {
+  QElapsedTimer timer;
+  timer.start();
+
+  db_.transaction();
+
+  if (!execScript(sql(u"migrations/%1"_s.arg(version)))) {
+    db_.rollback();
+    LOGE("Could not migrate database schema to version {}.", version);
+    return false;
   }
 
+  setMetaValue("schema_version", version);
+
   db_.commit();
-  db_.close();
+
+  LOGI("Migrated database schema to version {} in {} ms.", version, timer.elapsed());
+
+  return true;
+}
+
+bool Database::execScript(const QString& script) {
+  QSqlQuery q{db_};
+
+  for (const auto& statement : base::splitSqlStatements(script)) {
+    if (!q.exec(statement)) {
+      LOGE("{}", q.lastError().text().toStdString());
+      return false;
+    }
+  }
+
+  return true;
 }
 
 QString Database::currentVersion() {
-  if (!db_.open()) return {};
+  if (!db_.isOpen()) return {};
 
   QSqlQuery q{db_};
 
   if (!q.prepare("SELECT value FROM meta WHERE name = :name")) return {};
 
   q.bindValue(":name", "version");
-  q.exec();
-  const QString version = q.value(0).toString();
+  if (!q.exec() || !q.next()) return {};
+
+  return q.value(0).toString();
+}
+
+void Database::load() {
+  loader_ = QThread::create([this, fileName = fileName()]() {
+    QElapsedTimer timer;
+    timer.start();
 
-  db_.close();
+    {
+      auto db = QSqlDatabase::addDatabase("QSQLITE", kLoaderConnectionName);
+      db.setDatabaseName(fileName);
+      db.setConnectOptions("QSQLITE_OPEN_READONLY");
 
-  return version;
+      if (!db.open()) {
+        LOGE("{}", db.lastError().text().toStdString());
+      } else {
+        QSqlQuery{db}.exec("PRAGMA mmap_size = 268435456");
+        readItems(db);
+        readEntries(db);
+        db.close();
+      }
+    }
+    QSqlDatabase::removeDatabase(kLoaderConnectionName);
+
+    if (QThread::currentThread()->isInterruptionRequested()) return;
+
+    LOGD("Loaded database in {} ms.", timer.elapsed());
+
+    QMetaObject::invokeMethod(this, &Database::setReady, Qt::QueuedConnection);
+  });
+
+  connect(loader_, &QThread::finished, loader_, &QObject::deleteLater);
+
+  loader_->start();
 }
 
-void Database::readItems() {
-  if (!db_.open()) return;
+bool Database::loadCache(const cache::Stamp& stamp) {
+  QElapsedTimer timer;
+  timer.start();
 
-  QSqlQuery q{db_};
-  if (!q.exec("SELECT * FROM anime")) return;
+  std::vector<Anime> items;
+  std::vector<ListEntry> entries;
+
+  if (!cache::read(cacheFileName(), stamp, kSchemaVersion, items, entries)) return false;
+
+  addLoadedItems(items);
+  addLoadedEntries(entries);
+
+  LOGD("Loaded database from cache in {} ms.", timer.elapsed());
+
+  return true;
+}
+
+void Database::writeCache() const {
+  const auto stamp = cache::databaseStamp(fileName());
+
+  if (!stamp) {
+    QFile::remove(cacheFileName());
+    return;
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+
+  if (!cache::write(cacheFileName(), *stamp, kSchemaVersion, items_, entries_)) {
+    LOGW("Could not write database cache.");
+    return;
+  }
+
+  LOGD("Wrote database cache in {} ms.", timer.elapsed());
+}
+
+void Database::setReady() {
+  ready_ = true;
+
+  snapshot_.store(std::make_shared<const Snapshot>(Snapshot::items_t{}.with(items_),
+                                                   Snapshot::entries_t{}.with(entries_)));
+
+  emit ready();
+}
+
+void Database::readItems(const QSqlDatabase& db) {
+  QSqlQuery q{db};
+  q.setForwardOnly(true);
+  if (!q.exec(sql("selectAnime"))) return;
+
+  RelationReader synonyms{
+      db, "SELECT anime_id, title FROM anime_synonym ORDER BY anime_id, position"};
+
+  std::vector<std::pair<RelationReader, std::vector<Symbol> Anime::*>> relations;
+  for (const auto& [table, member] : kRelations) {
+    const auto query = u"SELECT r.anime_id, t.id, t.name FROM anime_%1 r "
+                       u"JOIN %1 t ON t.id = r.%1_id "
+                       u"ORDER BY r.anime_id, r.position"_s.arg(table);
+    relations.emplace_back(RelationReader{db, query}, member);
+  }
+
+  std::vector<Anime> chunk;
+  chunk.reserve(kLoadChunkSize);
+
+  const auto flush = [this, &chunk]() {
+    QMetaObject::invokeMethod(
+        this, [this, items = std::move(chunk)]() mutable { addLoadedItems(items); },
+        Qt::QueuedConnection);
+    chunk = {};
+    chunk.reserve(kLoadChunkSize);
+  };
 
   while (q.next()) {
-    const int id = q.value("id").toInt();
-    items_[id] = itemFromQuery(q);
+    auto& item = chunk.emplace_back(itemFromQuery(q));
+    synonyms.read(item.id, item.titles.synonyms);
+    for (auto& [reader, member] : relations) {
+      reader.read(item.id, item.*member);
+    }
+    if (chunk.size() == kLoadChunkSize) {
+      if (QThread::currentThread()->isInterruptionRequested()) return;
+      flush();
+    }
   }
 
-  db_.close();
+  if (!chunk.empty()) flush();
 }
 
-void Database::readEntries() {
-  if (!db_.open()) return;
+void Database::readEntries(const QSqlDatabase& db) {
+  QSqlQuery q{db};
+  q.setForwardOnly(true);
+  if (!q.exec(sql("selectAnimeList"))) return;
 
-  QSqlQuery q{db_};
-  if (!q.exec("SELECT * FROM anime_list")) return;
+  std::vector<ListEntry> chunk;
+  chunk.reserve(kLoadChunkSize);
+
+  const auto flush = [this, &chunk]() {
+    QMetaObject::invokeMethod(
+        this, [this, entries = std::move(chunk)]() mutable { addLoadedEntries(entries); },
+        Qt::QueuedConnection);
+    chunk = {};
+    chunk.reserve(kLoadChunkSize);
+  };
 
   while (q.next()) {
-    const int id = q.value("media_id").toInt();
-    entries_[id] = entryFromQuery(q);
+    chunk.emplace_back(entryFromQuery(q));
+    if (chunk.size() == kLoadChunkSize) {
+      if (QThread::currentThread()->isInterruptionRequested()) return;
+      flush();
+    }
+  }
+
+  if (!chunk.empty()) flush();
+}
+
+void Database::addLoadedItems(std::vector<Anime>& items) {
+  QList<int> ids;
+  ids.reserve(items.size());
+
+  list::Statistics delta;
+
+  for (auto& item : items) {
+    // Items that were written while loading are newer than what we've read from the disk
+    if (items_.contains(item.id)) continue;
+    ids.push_back(item.id);
+    index_.insertItem(item);
+    delta -= entryStatistics(item.id);
+    items_[item.id] = std::move(item);
+    delta += entryStatistics(item.id);
+  }
+
+  if (ids.isEmpty()) return;
+
+  applyStatistics(delta);
+
+  publishSnapshot({ids.constData(), static_cast<size_t>(ids.size())}, {});
+
+  emit itemsUpdated(ids);
+}
+
+void Database::addLoadedEntries(std::vector<ListEntry>& entries) {
+  QList<int> ids;
+  ids.reserve(entries.size());
+
+  list::Statistics delta;
+
+  for (auto& entry : entries) {
+    if (entries_.contains(entry.anime_id)) continue;
+    ids.push_back(entry.anime_id);
+    index_.insertEntry(entry);
+    entries_[entry.anime_id] = std::move(entry);
+    delta += entryStatistics(ids.back());
+  }
+
+  if (ids.isEmpty()) return;
+
+  applyStatistics(delta);
+
+  publishSnapshot({}, {ids.constData(), static_cast<size_t>(ids.size())});
+
+  emit entriesUpdated(ids);
+}
+
+bool Database::writeItems(std::span<const Anime> items) {
+  if (!db_.isOpen()) return false;
+
+  const auto q = statements_.get("insertAnime");
+  if (!q) return false;
+
+  // During the migration, rows are written as part of its transaction
+  const bool transaction = !migrating_;
+
+  if (transaction) db_.transaction();
+
+  list::Statistics delta;
+
+  for (const auto& item : items) {
+    // Items without extras are written back with the ones that are already stored
+    const auto extras = item.extras ? item.extras : this->extras(item.id);
+    bindItemToQuery(item, *extras, *q);
+    if (!q->exec()) LOGW("{}", q->lastError().text().toStdString());
+    writeItemRelations(item);
+    writeItemSearch(item, *extras);
+    delta -= entryStatistics(item.id);
+    auto& stored = items_[item.id];
+    stored = item;
+    stored.extras.reset();
+    index_.insertItem(stored);
+    delta += entryStatistics(item.id);
+    extras_.insert(item.id, extras);
   }
 
-  db_.close();
+  if (transaction) db_.commit();
+
+  applyStatistics(delta);
+
+  publishSnapshot(items | std::views::transform(&Anime::id) | std::ranges::to<std::vector>(),
+                  {});
+
+  return true;
+}
+
+void Database::startWriter() {
+  writerThread_ = std::make_unique<QThread>();
+  writer_ = std::make_unique<DatabaseWriter>(fileName(),
+                                             [this](const QString& name) { return sql(name); });
+  writer_->moveToThread(writerThread_.get());
+  writerThread_->start();
+
+  QMetaObject::invokeMethod(writer_.get(), &DatabaseWriter::open, Qt::QueuedConnection);
+}
+
+void Database::stopWriter() {
+  if (!writer_) return;
+
+  // Pending entries are written in a last batch before the connection is closed, along with the
+  // batch in flight in case that one fails. The writer handles calls in the order in which they
+  // are made, so newer values are written last.
+  auto entries = std::exchange(writingEntries_, {});
+  auto tombstones = std::exchange(writingTombstones_, {});
+  writing_ = false;
+  for (const auto& entry : std::as_const(pendingEntries_)) {
+    tombstones.remove(entry.anime_id);
+    entries.insert(entry.anime_id, entry);
+  }
+  for (const auto& tombstone : std::as_const(pendingTombstones_)) {
+    entries.remove(tombstone.anime_id);
+    tombstones.insert(tombstone.anime_id, tombstone);
+  }
+  pendingEntries_.clear();
+  pendingTombstones_.clear();
+
+  if (!entries.isEmpty() || !tombstones.isEmpty()) {
+    bool written = false;
+    QMetaObject::invokeMethod(
+        writer_.get(),
+        [&written, writer = writer_.get(), &entries, &tombstones]() {
+          written = writer->writeEntries({entries.cbegin(), entries.cend()},
+                                         {tombstones.cbegin(), tombstones.cend()});
+        },
+        Qt::BlockingQueuedConnection);
+    if (!written) {
+      LOGE("Could not write {} list entries and {} tombstones.", entries.size(),
+           tombstones.size());
+    }
+  }
+
+  QMetaObject::invokeMethod(writer_.get(), &DatabaseWriter::close, Qt::BlockingQueuedConnection);
+
+  writerThread_->quit();
+  writerThread_->wait();
+
+  writer_.reset();
+  writerThread_.reset();
+}
+
+void Database::queueEntries(std::span<const ListEntry> entries) {
+  list::Statistics delta;
+
+  for (const auto& entry : entries) {
+    delta -= entryStatistics(entry.anime_id);
+    entries_[entry.anime_id] = entry;
+    index_.insertEntry(entry);
+    delta += entryStatistics(entry.anime_id);
+    pendingEntries_.insert(entry.anime_id, entry);  // replaces any earlier update
+    pendingTombstones_.remove(entry.anime_id);
+  }
+
+  applyStatistics(delta);
+
+  publishSnapshot({}, entries | std::views::transform(&ListEntry::anime_id) |
+                          std::ranges::to<std::vector>());
+
+  scheduleFlush();
+}
+
+void Database::queueTombstones(std::span<const int> ids) {
+  const auto now = std::time(nullptr);
+
+  for (const int id : ids) {
+    const auto entry = entries_.find(id);
+    if (!entry) continue;
+    pendingTombstones_.insert(id, {.anime_id = id, .id = entry->id, .removed_at = now});
+    pendingEntries_.remove(id);  // replaces any earlier update
+    index_.removeEntry(*entry);
+    entries_.erase(id);
+  }
+
+  publishSnapshot({}, {}, ids);
+
+  scheduleFlush();
+}
+
+void Database::scheduleFlush() {
+  if (flushScheduled_) return;
+
+  flushScheduled_ = true;
+  QTimer::singleShot(kFlushDelayMs, this, &Database::flushEntries);
 }
 
-void Database::bindItemToQuery(const Anime& item, QSqlQuery& q) const {
+void Database::flushEntries() {
+  flushScheduled_ = false;
+
+  // The writer would have to wait for the migration to commit
+  if (pendingEntries_.isEmpty() && pendingTombstones_.isEmpty()) return;
+  if (!writer_ || migrating_) return;
+
+  // Batches are written one at a time, so that a failed batch can be queued again before the
+  // next one is written. The next batch is flushed once this one is done.
+  if (writing_) return;
+
+  writing_ = true;
+  writingEntries_ = std::exchange(pendingEntries_, {});
+  writingTombstones_ = std::exchange(pendingTombstones_, {});
+
+  std::vector<ListEntry> entries{writingEntries_.cbegin(), writingEntries_.cend()};
+  std::vector<list::Tombstone> tombstones{writingTombstones_.cbegin(), writingTombstones_.cend()};
+
+  QMetaObject::invokeMethod(
+      writer_.get(),
+      [this, writer = writer_.get(), entries = std::move(entries),
+       tombstones = std::move(tombstones)]() {
+        const bool written = writer->writeEntries(entries, tombstones);
+        QMetaObject::invokeMethod(
+            this, [this, written]() { finishFlush(written); }, Qt::QueuedConnection);
+      },
+      Qt::QueuedConnection);
+}
+
+void Database::finishFlush(const bool written) {
+  if (!writing_) return;  // the batch was written again when the writer was stopped
+
+  writing_ = false;
+
+  if (!written) {
+    LOGW("Could not write {} list entries and {} tombstones, will try again.",
+         writingEntries_.size(), writingTombstones_.size());
+
+    // Updates that were made while the batch was being written are newer
+    for (const auto& entry : std::as_const(writingEntries_)) {
+      if (pendingEntries_.contains(entry.anime_id)) continue;
+      if (pendingTombstones_.contains(entry.anime_id)) continue;
+      pendingEntries_.insert(entry.anime_id, entry);
+    }
+    for (const auto& tombstone : std::as_const(writingTombstones_)) {
+      if (pendingEntries_.contains(tombstone.anime_id)) continue;
+      if (pendingTombstones_.contains(tombstone.anime_id)) continue;
+      pendingTombstones_.insert(tombstone.anime_id, tombstone);
+    }
+  }
+
+  writingEntries_.clear();
+  writingTombstones_.clear();
+
+  if (!pendingEntries_.isEmpty() || !pendingTombstones_.isEmpty()) scheduleFlush();
+}
+
+void Database::writeItemRelations(const Anime& item) {
+  static const auto exec = [](QSqlQuery& q) {
+    if (!q.exec()) LOGW("{}", q.lastError().text().toStdString());
+  };
+
+  // Synonyms
+  if (const auto q = statements_.get("deleteAnimeSynonyms")) {
+    q->bindValue(":anime_id", item.id);
+    exec(*q);
+  }
+  if (const auto q = statements_.get("insertAnimeSynonym")) {
+    for (size_t i = 0; i < item.titles.synonyms.size(); ++i) {
+      q->bindValue(":anime_id", item.id);
+      q->bindValue(":position", static_cast<int>(i));
+      q->bindValue(":title", QString::fromStdString(item.titles.synonyms[i]));
+      exec(*q);
+    }
+  }
+
+  // Genres, producers, studios and tags
+  for (const auto& [table, member] : kRelations) {
+    const auto qDelete =
+        statements_.get(u"delete:anime_%1"_s.arg(table),
+                        u"DELETE FROM anime_%1 WHERE anime_id = :anime_id"_s.arg(table));
+    const auto qInsertName =
+        statements_.get(u"insert:%1"_s.arg(table),
+                        u"INSERT OR IGNORE INTO %1(name) VALUES(:name)"_s.arg(table));
+    const auto qInsertLink = statements_.get(
+        u"insert:anime_%1"_s.arg(table),
+        u"INSERT OR IGNORE INTO anime_%1(anime_id, %1_id, position) "
+        u"SELECT :anime_id, id, :position FROM %1 WHERE name = :name"_s.arg(table));
+    if (!qDelete || !qInsertName || !qInsertLink) continue;
+
+    qDelete->bindValue(":anime_id", item.id);
+    exec(*qDelete);
+
+    // Names that could not be interned have lost their text, and are left out
+    int position = 0;
+    for (const auto symbol : item.*member) {
+      if (symbol == base::SymbolTable::kEmpty) continue;
+      const auto name = QString::fromUtf8(symbols.name(symbol));
+      qInsertName->bindValue(":name", name);
+      exec(*qInsertName);
+      qInsertLink->bindValue(":anime_id", item.id);
+      qInsertLink->bindValue(":position", position++);
+      qInsertLink->bindValue(":name", name);
+      exec(*qInsertLink);
+    }
+  }
+}
+
+void Database::writeItemSearch(const Anime& item, const Extras& extras) {
+  const auto qDelete = statements_.get("deleteAnimeSearch");
+  const auto qInsert = statements_.get("insertAnimeSearch");
+  if (!qDelete || !qInsert) return;
+
+  qDelete->bindValue(":id", item.id);
+  if (!qDelete->exec()) LOGW("{}", qDelete->lastError().text().toStdString());
+
+  QStringList synonyms;
+  for (const auto& synonym : item.titles.synonyms) {
+    synonyms.push_back(QString::fromStdString(synonym));
+  }
+
+  qInsert->bindValue(":id", item.id);
+  qInsert->bindValue(":title", QString::fromStdString(item.titles.romaji));
+  qInsert->bindValue(":english", QString::fromStdString(item.titles.english));
+  qInsert->bindValue(":japanese", QString::fromStdString(item.titles.japanese));
+  qInsert->bindValue(":synonyms", synonyms.join('\n'));
+  qInsert->bindValue(":synopsis", QString::fromStdString(extras.synopsis));
+  if (!qInsert->exec()) LOGW("{}", qInsert->lastError().text().toStdString());
+}
+
+void Database::bindItemToQuery(const Anime& item, const Extras& extras, QSqlQuery& q) const {
   q.bindValue(":id", item.id);
   q.bindValue(":title", QString::fromStdString(item.titles.romaji));
   q.bindValue(":english", QString::fromStdString(item.titles.english));
   q.bindValue(":japanese", QString::fromStdString(item.titles.japanese));
-  q.bindValue(":synonym", joinStrings(item.titles.synonyms, ""));
   q.bindValue(":type", static_cast<int>(item.type));
   q.bindValue(":status", static_cast<int>(item.status));
   q.bindValue(":episode_count", item.episode_count);
   q.bindValue(":episode_length", item.episode_length);
   q.bindValue(":date_start", QString::fromStdString(item.date_started.to_string()));
   q.bindValue(":date_end", QString::fromStdString(item.date_finished.to_string()));
-  q.bindValue(":image", QString::fromStdString(item.image_url));
-  q.bindValue(":trailer_id", QString::fromStdString(item.trailer_id));
+  q.bindValue(":image", QString::fromStdString(extras.image_url));
+  q.bindValue(":slug", QString::fromStdString(extras.slug));
+  q.bindValue(":trailer_id", QString::fromStdString(extras.trailer_id));
   q.bindValue(":age_rating", static_cast<int>(item.age_rating));
-  q.bindValue(":genres", joinStrings(item.genres, ""));
-  q.bindValue(":tags", joinStrings(item.tags, ""));
-  q.bindValue(":producers", joinStrings(item.producers, ""));
-  q.bindValue(":studios", joinStrings(item.studios, ""));
-  q.bindValue(":score", QString::number(item.score));
+  q.bindValue(":score", item.score);
   q.bindValue(":popularity", item.popularity_rank);
-  q.bindValue(":synopsis", QString::fromStdString(item.synopsis));
+  q.bindValue(":synopsis", QString::fromStdString(extras.synopsis));
   q.bindValue(":last_aired_episode", item.last_aired_episode);
-  q.bindValue(":next_episode_time", QString::number(item.next_episode_time));
-  q.bindValue(":modified", QString::number(item.last_modified));
-}
-
-void Database::bindEntryToQuery(const ListEntry& entry, QSqlQuery& q) const {
-  q.bindValue(":id", entry.id);
-  q.bindValue(":media_id", entry.anime_id);
-  q.bindValue(":progress", entry.watched_episodes);
-  q.bindValue(":date_start", QString::fromStdString(entry.date_started.to_string()));
-  q.bindValue(":date_end", QString::fromStdString(entry.date_completed.to_string()));
-  q.bindValue(":score", entry.score);
-  q.bindValue(":status", static_cast<int>(entry.status));
-  q.bindValue(":private", entry.is_private);
-  q.bindValue(":rewatched_times", entry.rewatched_times);
-  q.bindValue(":rewatching", entry.rewatching);
-  q.bindValue(":rewatching_ep", entry.rewatching_ep);
-  q.bindValue(":notes", QString::fromStdString(entry.notes));
-  q.bindValue(":last_updated", QString::number(entry.last_updated));
+  q.bindValue(":next_episode_time", static_cast<qint64>(item.next_episode_time));
+  q.bindValue(":modified", static_cast<qint64>(item.last_modified));
 }
 
 Anime Database::itemFromQuery(const QSqlQuery& q) const {
-  static const auto splitToVector = [](const QVariant& variant) {
-    return toVector(variant.toString().split(", ", Qt::SkipEmptyParts));
-  };
   return {
-      .id = q.value("id").toInt(),
-      .last_modified = q.value("modified").toInt(),
-      .episode_count = q.value("episode_count").toInt(),
-      .episode_length = q.value("episode_length").toInt(),
-      .age_rating = q.value("age_rating").value<anime::AgeRating>(),
-      .status = q.value("status").value<anime::Status>(),
-      .type = q.value("type").value<anime::Type>(),
-      .date_started = FuzzyDate(q.value("date_start").toString().toStdString()),
-      .date_finished = FuzzyDate(q.value("date_end").toString().toStdString()),
-      .score = q.value("score").toFloat(),
-      .popularity_rank = q.value("popularity").toInt(),
-      .image_url = q.value("image").toString().toStdString(),
-      .synopsis = q.value("synopsis").toString().toStdString(),
-      .trailer_id = q.value("trailer_id").toString().toStdString(),
+      .id = q.value(kAnimeId).toInt(),
+      .last_modified = q.value(kAnimeModified).toLongLong(),
+      .episode_count = q.value(kAnimeEpisodeCount).toInt(),
+      .episode_length = q.value(kAnimeEpisodeLength).toInt(),
+      .age_rating = static_cast<anime::AgeRating>(q.value(kAnimeAgeRating).toInt()),
+      .status = static_cast<anime::Status>(q.value(kAnimeStatus).toInt()),
+      .type = static_cast<anime::Type>(q.value(kAnimeType).toInt()),
+      .date_started = FuzzyDate(textValue(q, kAnimeDateStart)),
+      .date_finished = FuzzyDate(textValue(q, kAnimeDateEnd)),
+      .score = q.value(kAnimeScore).toFloat(),
+      .popularity_rank = q.value(kAnimePopularity).toInt(),
       .titles{
-          .romaji = q.value("title").toString().toStdString(),
-          .english = q.value("english").toString().toStdString(),
-          .japanese = q.value("japanese").toString().toStdString(),
-          .synonyms = splitToVector(q.value("synonym")),
+          .romaji = textValue(q, kAnimeTitle),
+          .english = textValue(q, kAnimeEnglish),
+          .japanese = textValue(q, kAnimeJapanese),
       },
-      .genres = splitToVector(q.value("genres")),
-      .producers = splitToVector(q.value("producers")),
-      .studios = splitToVector(q.value("studios")),
-      .tags = splitToVector(q.value("tags")),
-      .last_aired_episode = q.value("last_aired_episode").toInt(),
-      .next_episode_time = q.value("next_episode_time").toInt(),
+      .last_aired_episode = q.value(kAnimeLastAiredEpisode).toInt(),
+      .next_episode_time = q.value(kAnimeNextEpisodeTime).toLongLong(),
   };
 }
 
 ListEntry Database::entryFromQuery(const QSqlQuery& q) const {
   return {
-      .id = q.value("id").toLongLong(),
-      .anime_id = q.value("media_id").toInt(),
-      .watched_episodes = q.value("progress").toInt(),
-      .score = q.value("score").toInt(),
-      .status = q.value("status").value<anime::list::Status>(),
-      .is_private = q.value("private").toBool(),
-      .rewatched_times = q.value("rewatched_times").toInt(),
-      .rewatching = q.value("rewatching").toBool(),
-      .rewatching_ep = q.value("rewatching_ep").toInt(),
-      .date_started = FuzzyDate(q.value("date_start").toString().toStdString()),
-      .date_completed = FuzzyDate(q.value("date_end").toString().toStdString()),
-      .last_updated = q.value("last_updated").toInt(),
-      .notes = q.value("notes").toString().toStdString(),
+      .id = q.value(kListId).toLongLong(),
+      .anime_id = q.value(kListMediaId).toInt(),
+      .watched_episodes = q.value(kListProgress).toInt(),
+      .score = q.value(kListScore).toInt(),
+      .status = static_cast<anime::list::Status>(q.value(kListStatus).toInt()),
+      .is_private = q.value(kListPrivate).toBool(),
+      .rewatched_times = q.value(kListRewatchedTimes).toInt(),
+      .rewatching = q.value(kListRewatching).toBool(),
+      .rewatching_ep = q.value(kListRewatchingEp).toInt(),
+      .date_started = FuzzyDate(textValue(q, kListDateStart)),
+      .date_completed = FuzzyDate(textValue(q, kListDateEnd)),
+      .last_updated = q.value(kListLastUpdated).toInt(),
+      .notes = textValue(q, kListNotes),
   };
 }
 
-void Database::migrateItemsFromV1() {
-  if (!db_.open()) return;
+void Database::migrateFromV1() {
+  const auto itemsPath = std::format("{}/v1/db/anime.xml", taiga::get_data_path());
+  const auto entriesPath = []() {
+    const auto service = taiga::settings.service();
+    return std::format("{}/v1/user/{}@{}/anime.xml", taiga::get_data_path(),
+                       taiga::accounts.serviceUsername(service), service);
+  }();
 
-  QSqlQuery q{db_};
-  if (!q.prepare(sql("insertAnime"))) return;
+  // Files are read and decoded in the background, while the rows are written on this thread in a
+  // single transaction that is committed once both files have been read.
+  migrating_ = db_.transaction();
 
-  const auto path = std::format("{}/v1/db/anime.xml", taiga::get_data_path());
+  // Items are stored with their AniList ids, as they are everywhere else, along with their ids on
+  // the other services. v1 kept the list with the ids of the current service, so list entries
+  // are mapped through the ids of the items that were read before them.
+  const auto listService = sync::currentServiceId();
 
-  db_.transaction();
+  loader_ = QThread::create([this, itemsPath, entriesPath, listService]() {
+    QElapsedTimer timer;
+    timer.start();
 
-  for (const auto& item : compat::v1::readAnimeDatabase(path)) {
-    items_[item.id] = item;
-    bindItemToQuery(item, q);
-    q.exec();
-  }
+    const auto isInterrupted = []() {
+      return QThread::currentThread()->isInterruptionRequested();
+    };
 
-  db_.commit();
-  db_.close();
-}
+    std::vector<Uid> skippedItems;
 
-void Database::migrateListEntriesFromV1() {
-  if (!db_.open()) return;
+    compat::v1::readAnimeDatabase(
+        itemsPath, sync::ServiceId::AniList,
+        [this, &isInterrupted](std::vector<Anime>&& items, std::vector<Uid>&& uids,
+                               const int progress) {
+          if (isInterrupted()) return false;
+          QMetaObject::invokeMethod(
+              this,
+              [this, items = std::move(items), uids = std::move(uids), progress]() {
+                updateItems(items);
+                updateUids(uids);
+                emit migrationProgress(progress);
+              },
+              Qt::QueuedConnection);
+          return true;
+        },
+        skippedItems);
 
-  QSqlQuery q{db_};
-  if (!q.prepare(sql("insertAnimeList"))) return;
+    if (!skippedItems.empty()) {
+      LOGW("Left out {} v1 items that have no AniList id: {}", skippedItems.size(),
+           formatUids(skippedItems));
+    }
 
-  const auto path = []() {
-    const auto service = taiga::settings.service();
-    return std::format("{}/v1/user/{}@{}/anime.xml", taiga::get_data_path(),
-                       taiga::accounts.serviceUsername(service), service);
-  }();
+    compat::v1::readListEntries(
+        entriesPath,
+        [this, &isInterrupted, listService](std::vector<ListEntry>&& entries, const int) {
+          if (isInterrupted()) return false;
+          QMetaObject::invokeMethod(
+              this,
+              [this, listService, entries = std::move(entries)]() mutable {
+                const auto serviceIds = entries | std::views::transform(&ListEntry::anime_id) |
+                                        std::ranges::to<std::vector>();
+                const auto ids = resolveIds(listService, serviceIds);
+                std::vector<ListEntry> migrated;
+                std::vector<Uid> skipped;
+                for (auto& entry : entries) {
+                  const int id = ids.value(entry.anime_id, kUnknownId);
+                  if (!items_.contains(id)) {
+                    skipped.push_back({.service = listService, .service_id = entry.anime_id});
+                    continue;
+                  }
+                  entry.anime_id = id;
+                  migrated.push_back(std::move(entry));
+                }
+                if (!skipped.empty()) {
+                  LOGW("Left out {} v1 list entries whose items were not migrated: {}",
+                       skipped.size(), formatUids(skipped));
+                  migrationSkippedEntries_ += skipped.size();
+                }
+                updateEntries(migrated);
+              },
+              Qt::QueuedConnection);
+          return true;
+        });
 
-  db_.transaction();
+    if (isInterrupted()) return;
 
-  for (const auto& entry : compat::v1::readListEntries(path)) {
-    if (!items_.contains(entry.anime_id)) continue;
-    entries_[entry.anime_id] = entry;
-    bindEntryToQuery(entry, q);
-    q.exec();
+    LOGD("Read v1 database in {} ms.", timer.elapsed());
+
+    QMetaObject::invokeMethod(
+        this, [this, skipped = skippedItems.size()]() { finishMigration(skipped); },
+        Qt::QueuedConnection);
+  });
+
+  connect(loader_, &QThread::finished, loader_, &QObject::deleteLater);
+
+  loader_->start();
+}
+
+void Database::finishMigration(const size_t skippedItems) {
+  if (migrating_) {
+    db_.commit();
+    migrating_ = false;
   }
 
-  db_.commit();
-  db_.close();
+  LOGI("Migrated v1 database with {} items and {} list entries.", items_.size(),
+       entries_.size());
+  if (skippedItems || migrationSkippedEntries_) {
+    LOGW("{} items and {} list entries could not be migrated, see the warnings above.",
+         skippedItems, migrationSkippedEntries_);
+  }
+
+  flushEntries();
+
+  setReady();
 }
 
 }  // namespace anime
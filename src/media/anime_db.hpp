@@ -18,15 +18,36 @@
 
 #pragma once
 
-#include <QMap>
+#include <QHash>
+#include <QPointer>
 #include <QSqlDatabase>
 #include <QSqlQuery>
-
+#include <QThread>
+#include <atomic>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "base/flat_store.hpp"
+#include "base/lru_cache.hpp"
+#include "base/sql.hpp"
 #include "media/anime.hpp"
+#include "media/anime_db_cache.hpp"
+#include "media/anime_db_index.hpp"
+#include "media/anime_db_writer.hpp"
 #include "media/anime_list.hpp"
+#include "media/anime_snapshot.hpp"
 
 namespace anime {
 
+enum class SearchScope {
+  Titles,
+  TitlesAndSynopsis,
+};
+
 class Database final : public QObject {
   Q_OBJECT
   Q_DISABLE_COPY_MOVE(Database)
@@ -36,43 +57,172 @@ public:
   ~Database() = default;
 
   void init();
+  void close();
+
+  // Items and entries are loaded in the background after `init()`, and arrive in chunks through
+  // `itemsUpdated()` and `entriesUpdated()`. Recognition and synchronization must wait for
+  // `ready()` before they can rely on the database being complete.
+  bool isReady() const;
 
   const Anime* item(const int id) const;
   const ListEntry* entry(const int id) const;
 
-  const QMap<int, Anime>& items() const;
-  const QMap<int, ListEntry>& entries() const;
+  // Returns the fields that are not kept in memory with the item, which are loaded from the
+  // database on demand and cached for the most recently used items.
+  std::shared_ptr<const Extras> extras(const int id);
+
+  // Returns the ids of items that contain `query`, which must be at least three characters long,
+  // best matches first. A negative `limit` returns all matches.
+  QList<int> search(const QString& query, const int limit = -1,
+                    const SearchScope scope = SearchScope::Titles);
+  // Returns those of `ids` that contain `query`, in no particular order
+  QList<int> search(const QString& query, std::span<const int> ids,
+                    const SearchScope scope = SearchScope::Titles);
+
+  const base::FlatStore<Anime>& items() const;
+  const base::FlatStore<ListEntry>& entries() const;
+
+  // Secondary indexes over items and entries, which are updated along with them
+  const DatabaseIndex& index() const;
+
+  // Counts and totals over the list, which are updated along with the entries
+  const list::Statistics& listStatistics() const;
+
+  // Returns the latest snapshot of items and entries. Unlike the functions above, this can be
+  // called from any thread, and the snapshot remains valid while the database is being updated.
+  // The snapshot is empty until the database is ready, and a new snapshot is published after each
+  // batch of changes from then on.
+  std::shared_ptr<const Snapshot> snapshot() const;
 
   void updateItem(const Anime& item);
   void updateEntry(const ListEntry& entry);
 
+  // Writes the whole batch in a single transaction and emits a single signal
+  void updateItems(std::span<const Anime> items);
+
+  // List entries are updated in memory right away, and written to the disk shortly after on a
+  // background thread. Repeated updates to the same entry are coalesced into a single write.
+  void updateEntries(std::span<const ListEntry> entries);
+
+  // Entries are removed from memory right away, and from the disk along with other pending
+  // updates. Each one leaves a tombstone behind, which a later sync can reconcile against.
+  void removeEntry(const int id);
+  void removeEntries(std::span<const int> ids);
+
+  // Returns when the entry of the item was removed, if it has been removed and not added again
+  std::optional<std::time_t> entryRemovedAt(const int id);
+
+  // Ids of items on each service are kept in the database only. A mapping replaces any other
+  // mapping of the same service id, or of the same item on the same service.
+  void updateUids(std::span<const Uid> uids);
+
+  // Maps ids on `service` to the ids of the items here, and vice versa, in a single query. Ids
+  // that are not known are left out of the result.
+  QHash<int, int> resolveIds(const sync::ServiceId service, std::span<const int> serviceIds);
+  QHash<int, int> serviceIds(const sync::ServiceId service, std::span<const int> animeIds);
+
+  const base::SqlStatementCache::Stats& statementCacheStats() const;
+
 signals:
   void itemUpdated(const int id);
   void entryUpdated(const int id);
+  void itemsUpdated(const QList<int>& ids);
+  void entriesUpdated(const QList<int>& ids);
+  void entriesRemoved(const QList<int>& ids);
+  void ready();
+
+  // Carries only what has changed, see `listStatistics()` for the current values
+  void listStatisticsChanged(const anime::list::Statistics& delta);
+
+  // Reports the progress of reading the v1 database, which is migrated on first run
+  void migrationProgress(const int percent);
 
 private:
   QString fileName() const;
+  QString cacheFileName() const;
   QString sql(const QString& name) const;
+  void setPragmas();
 
-  void createTables();
   QString currentVersion();
+  int schemaVersion();
+  void setMetaValue(const QString& name, const QVariant& value);
+
+  void migrateSchema();
+  bool migrateSchemaTo(const int version);
+  bool execScript(const QString& script);
+
+  void load();
+  void setReady();
+
+  // The cache is a faster alternative to `load()`, as long as it's up to date with the database
+  bool loadCache(const cache::Stamp& stamp);
+  void writeCache() const;
 
-  void readItems();
-  void readEntries();
+  // These are called from the loader thread, with its own read-only connection
+  void readItems(const QSqlDatabase& db);
+  void readEntries(const QSqlDatabase& db);
 
-  void bindItemToQuery(const Anime& item, QSqlQuery& q) const;
-  void bindEntryToQuery(const ListEntry& entry, QSqlQuery& q) const;
+  void addLoadedItems(std::vector<Anime>& items);
+  void addLoadedEntries(std::vector<ListEntry>& entries);
+
+  // Returns what the entry of the item contributes to the list statistics
+  list::Statistics entryStatistics(const int id) const;
+  void applyStatistics(const list::Statistics& delta);
+
+  // Publishes the changes to a new snapshot, once the database is ready
+  void publishSnapshot(std::span<const int> itemIds, std::span<const int> entryIds,
+                       std::span<const int> removedEntryIds = {});
+
+  bool writeItems(std::span<const Anime> items);
+  QHash<int, int> selectIds(const QString& name, const sync::ServiceId service,
+                            std::span<const int> ids);
+  void writeItemRelations(const Anime& item);
+  void writeItemSearch(const Anime& item, const Extras& extras);
+
+  void startWriter();
+  void stopWriter();
+  void queueEntries(std::span<const ListEntry> entries);
+  void queueTombstones(std::span<const int> ids);
+  void scheduleFlush();
+  void flushEntries();
+  void finishFlush(const bool written);
+
+  void bindItemToQuery(const Anime& item, const Extras& extras, QSqlQuery& q) const;
 
   Anime itemFromQuery(const QSqlQuery& q) const;
   ListEntry entryFromQuery(const QSqlQuery& q) const;
 
-  void migrateItemsFromV1();
-  void migrateListEntriesFromV1();
+  void migrateFromV1();
+  void finishMigration(const size_t skippedItems);
 
   QSqlDatabase db_;
-
-  QMap<int, Anime> items_;
-  QMap<int, ListEntry> entries_;
+  base::SqlStatementCache statements_;
+
+  mutable QHash<QString, QString> sql_;
+  mutable std::mutex sql_mutex_;
+
+  QPointer<QThread> loader_;
+  std::unique_ptr<QThread> writerThread_;
+  std::unique_ptr<DatabaseWriter> writer_;
+  QHash<int, ListEntry> pendingEntries_;
+  QHash<int, list::Tombstone> pendingTombstones_;
+  // The batch that the writer is working on, which is kept until it's known to have been written,
+  // so that it can be queued again if it fails
+  QHash<int, ListEntry> writingEntries_;
+  QHash<int, list::Tombstone> writingTombstones_;
+  bool flushScheduled_ = false;
+  bool writing_ = false;
+  bool migrating_ = false;
+  size_t migrationSkippedEntries_ = 0;
+  bool ready_ = false;
+
+  base::FlatStore<Anime> items_;
+  base::LruCache<int, std::shared_ptr<const Extras>> extras_;
+  base::FlatStore<ListEntry> entries_;
+  DatabaseIndex index_;
+  list::Statistics statistics_;
+
+  std::atomic<std::shared_ptr<const Snapshot>> snapshot_;
 };
 
 inline Database db;
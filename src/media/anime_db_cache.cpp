@@ -0,0 +1,486 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2024, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "anime_db_cache.hpp"
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <array>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+#include "base/log.hpp"
+#include "base/string.hpp"
+
+namespace {
+
+constexpr std::array<char, 8> kMagic{'T', 'A', 'I', 'G', 'A', 'D', 'B', 'C'};
+
+// Must be incremented whenever the layout of the records below changes
+constexpr uint32_t kFormatVersion = 1;
+
+struct StringRef {
+  uint32_t offset = 0;
+  uint32_t length = 0;
+};
+
+struct ListRef {
+  uint32_t first = 0;
+  uint32_t count = 0;
+};
+
+struct PackedDate {
+  uint16_t year = 0;
+  uint8_t month = 0;
+  uint8_t day = 0;
+};
+
+struct Header {
+  std::array<char, 8> magic{};
+  uint32_t format_version = 0;
+  uint32_t schema_version = 0;
+  int64_t db_modified = 0;
+  int64_t db_size = 0;
+  uint32_t item_count = 0;
+  uint32_t entry_count = 0;
+  uint32_t symbol_count = 0;
+  uint32_t synonym_count = 0;
+  uint32_t symbol_ref_count = 0;
+  uint32_t reserved = 0;
+  uint64_t arena_size = 0;
+  uint64_t checksum = 0;  // of everything that follows the header
+};
+
+struct ItemRecord {
+  int64_t last_modified = 0;
+  int64_t next_episode_time = 0;
+  int32_t id = 0;
+  int32_t episode_count = 0;
+  int32_t episode_length = 0;
+  int32_t popularity_rank = 0;
+  int32_t last_aired_episode = 0;
+  float score = 0.0f;
+  PackedDate date_started;
+  PackedDate date_finished;
+  uint8_t age_rating = 0;
+  uint8_t status = 0;
+  uint8_t type = 0;
+  uint8_t reserved = 0;
+  StringRef romaji;
+  StringRef english;
+  StringRef japanese;
+  ListRef synonyms;   // into the synonym table
+  ListRef genres;     // into the symbol reference table, and so on
+  ListRef producers;
+  ListRef studios;
+  ListRef tags;
+  uint32_t padding = 0;  // makes the tail padding explicit, so that it's written as zeros
+};
+
+struct EntryRecord {
+  int64_t id = 0;
+  int64_t last_updated = 0;
+  int32_t anime_id = 0;
+  int32_t watched_episodes = 0;
+  int32_t score = 0;
+  int32_t rewatched_times = 0;
+  int32_t rewatching_ep = 0;
+  PackedDate date_started;
+  PackedDate date_completed;
+  uint8_t status = 0;
+  uint8_t is_private = 0;
+  uint8_t rewatching = 0;
+  uint8_t reserved = 0;
+  StringRef notes;
+};
+
+static_assert(std::is_trivially_copyable_v<Header>);
+static_assert(std::is_trivially_copyable_v<ItemRecord>);
+static_assert(std::is_trivially_copyable_v<EntryRecord>);
+
+// Records are written as they are in memory, and must not contain padding, which would be left
+// uninitialized and make the image and its checksum differ between writes of the same data. The
+// sizes are the sums of the sizes of the members.
+static_assert(sizeof(Header) == 72);
+static_assert(sizeof(ItemRecord) == 120);
+static_assert(sizeof(EntryRecord) == 56);
+
+uint64_t checksum(std::span<const char> data) {
+  // FNV-1a
+  uint64_t hash = 0xcbf29ce484222325;
+  for (const auto c : data) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001b3;
+  }
+  return hash;
+}
+
+PackedDate packDate(const FuzzyDate& date) {
+  return {
+      .year = static_cast<uint16_t>(date.year()),
+      .month = static_cast<uint8_t>(date.month()),
+      .day = static_cast<uint8_t>(date.day()),
+  };
+}
+
+FuzzyDate unpackDate(const PackedDate& packed) {
+  FuzzyDate date;
+  date.set_year(packed.year);
+  date.set_month(packed.month);
+  date.set_day(packed.day);
+  return date;
+}
+
+class ImageWriter final {
+public:
+  StringRef addString(std::string_view str) {
+    const StringRef ref{static_cast<uint32_t>(arena_.size()), static_cast<uint32_t>(str.size())};
+    arena_.append(str);
+    return ref;
+  }
+
+  ListRef addSynonyms(const std::vector<std::string>& synonyms) {
+    const ListRef ref{static_cast<uint32_t>(synonyms_.size()),
+                      static_cast<uint32_t>(synonyms.size())};
+    for (const auto& synonym : synonyms) {
+      synonyms_.push_back(addString(synonym));
+    }
+    return ref;
+  }
+
+  // Symbols are process-local, so each one is written once by name and referred to by index
+  ListRef addSymbols(const std::vector<anime::Symbol>& symbols) {
+    ListRef ref{static_cast<uint32_t>(symbol_refs_.size()), 0};
+    for (const auto symbol : symbols) {
+      // Names that could not be interned have lost their text, and are left out
+      if (symbol == base::SymbolTable::kEmpty) continue;
+      ++ref.count;
+      auto [it, inserted] = symbol_indexes_.try_emplace(symbol, symbol_names_.size());
+      if (inserted) symbol_names_.push_back(addString(anime::symbols.name(symbol)));
+      symbol_refs_.push_back(it->second);
+    }
+    return ref;
+  }
+
+  void addItem(const Anime& item) {
+    items_.push_back({
+        .last_modified = item.last_modified,
+        .next_episode_time = item.next_episode_time,
+        .id = item.id,
+        .episode_count = item.episode_count,
+        .episode_length = item.episode_length,
+        .popularity_rank = item.popularity_rank,
+        .last_aired_episode = item.last_aired_episode,
+        .score = item.score,
+        .date_started = packDate(item.date_started),
+        .date_finished = packDate(item.date_finished),
+        .age_rating = static_cast<uint8_t>(item.age_rating),
+        .status = static_cast<uint8_t>(item.status),
+        .type = static_cast<uint8_t>(item.type),
+        .romaji = addString(item.titles.romaji),
+        .english = addString(item.titles.english),
+        .japanese = addString(item.titles.japanese),
+        .synonyms = addSynonyms(item.titles.synonyms),
+        .genres = addSymbols(item.genres),
+        .producers = addSymbols(item.producers),
+        .studios = addSymbols(item.studios),
+        .tags = addSymbols(item.tags),
+    });
+  }
+
+  void addEntry(const ListEntry& entry) {
+    entries_.push_back({
+        .id = entry.id,
+        .last_updated = entry.last_updated,
+        .anime_id = entry.anime_id,
+        .watched_episodes = entry.watched_episodes,
+        .score = entry.score,
+        .rewatched_times = entry.rewatched_times,
+        .rewatching_ep = entry.rewatching_ep,
+        .date_started = packDate(entry.date_started),
+        .date_completed = packDate(entry.date_completed),
+        .status = static_cast<uint8_t>(entry.status),
+        .is_private = entry.is_private,
+        .rewatching = entry.rewatching,
+        .notes = addString(entry.notes),
+    });
+  }
+
+  QByteArray image(const anime::cache::Stamp& stamp, const int schemaVersion) const {
+    QByteArray body;
+    append(body, items_);
+    append(body, entries_);
+    append(body, symbol_names_);
+    append(body, synonyms_);
+    append(body, symbol_refs_);
+    body.append(arena_.data(), arena_.size());
+
+    const Header header{
+        .magic = kMagic,
+        .format_version = kFormatVersion,
+        .schema_version = static_cast<uint32_t>(schemaVersion),
+        .db_modified = stamp.modified,
+        .db_size = stamp.size,
+        .item_count = static_cast<uint32_t>(items_.size()),
+        .entry_count = static_cast<uint32_t>(entries_.size()),
+        .symbol_count = static_cast<uint32_t>(symbol_names_.size()),
+        .synonym_count = static_cast<uint32_t>(synonyms_.size()),
+        .symbol_ref_count = static_cast<uint32_t>(symbol_refs_.size()),
+        .arena_size = arena_.size(),
+        .checksum = checksum({body.constData(), static_cast<size_t>(body.size())}),
+    };
+
+    QByteArray image{reinterpret_cast<const char*>(&header), sizeof(header)};
+    image.append(body);
+    return image;
+  }
+
+private:
+  template <typename T>
+  static void append(QByteArray& data, const std::vector<T>& values) {
+    data.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+  }
+
+  std::vector<ItemRecord> items_;
+  std::vector<EntryRecord> entries_;
+  std::vector<StringRef> symbol_names_;
+  std::vector<StringRef> synonyms_;
+  std::vector<uint32_t> symbol_refs_;
+  std::unordered_map<anime::Symbol, uint32_t> symbol_indexes_;
+  std::string arena_;
+};
+
+// Reads from the mapped image, with every access checked against the bounds of its section
+class ImageReader final {
+public:
+  explicit ImageReader(std::span<const char> data) : data_{data} {}
+
+  bool readHeader(Header& header) {
+    return read(header);
+  }
+
+  template <typename T>
+  bool readSection(const uint64_t count, std::span<const char>& section) {
+    const uint64_t size = count * sizeof(T);
+    if (size > data_.size() - position_) return false;
+    section = data_.subspan(position_, size);
+    position_ += size;
+    return true;
+  }
+
+  bool atEnd() const {
+    return position_ == data_.size();
+  }
+
+private:
+  template <typename T>
+  bool read(T& value) {
+    if (sizeof(T) > data_.size() - position_) return false;
+    std::memcpy(&value, data_.data() + position_, sizeof(T));
+    position_ += sizeof(T);
+    return true;
+  }
+
+  std::span<const char> data_;
+  size_t position_ = 0;
+};
+
+template <typename T>
+T recordAt(std::span<const char> section, const size_t index) {
+  T record;
+  std::memcpy(&record, section.data() + index * sizeof(T), sizeof(T));
+  return record;
+}
+
+}  // namespace
+
+namespace anime::cache {
+
+std::optional<Stamp> databaseStamp(const QString& fileName) {
+  const QFileInfo info{fileName};
+  if (!info.exists()) return std::nullopt;
+
+  if (const QFileInfo wal{fileName + u"-wal"_s}; wal.exists() && wal.size() > 0) {
+    return std::nullopt;
+  }
+
+  return Stamp{
+      .modified = info.lastModified().toMSecsSinceEpoch(),
+      .size = info.size(),
+  };
+}
+
+bool write(const QString& fileName, const Stamp& stamp, const int schemaVersion,
+           const base::FlatStore<Anime>& items, const base::FlatStore<ListEntry>& entries) {
+  ImageWriter writer;
+
+  for (const auto& item : items) {
+    writer.addItem(item);
+  }
+  for (const auto& entry : entries) {
+    writer.addEntry(entry);
+  }
+
+  // The image replaces the previous one only once it's completely written
+  QSaveFile file{fileName};
+
+  if (!file.open(QIODevice::WriteOnly)) {
+    LOGW("{}", file.errorString().toStdString());
+    return false;
+  }
+
+  file.write(writer.image(stamp, schemaVersion));
+
+  return file.commit();
+}
+
+bool read(const QString& fileName, const Stamp& stamp, const int schemaVersion,
+          std::vector<Anime>& items, std::vector<ListEntry>& entries) {
+  QFile file{fileName};
+
+  if (!file.open(QIODevice::ReadOnly)) return false;
+
+  const auto data = file.map(0, file.size());
+  if (!data) return false;
+
+  ImageReader reader{{reinterpret_cast<const char*>(data), static_cast<size_t>(file.size())}};
+
+  Header header;
+  if (!reader.readHeader(header)) return false;
+
+  if (header.magic != kMagic || header.format_version != kFormatVersion ||
+      header.schema_version != static_cast<uint32_t>(schemaVersion) ||
+      header.db_modified != stamp.modified || header.db_size != stamp.size) {
+    LOGD("Cache image is out of date.");
+    return false;
+  }
+
+  std::span<const char> itemSection;
+  std::span<const char> entrySection;
+  std::span<const char> symbolSection;
+  std::span<const char> synonymSection;
+  std::span<const char> symbolRefSection;
+  std::span<const char> arena;
+
+  if (!reader.readSection<ItemRecord>(header.item_count, itemSection) ||
+      !reader.readSection<EntryRecord>(header.entry_count, entrySection) ||
+      !reader.readSection<StringRef>(header.symbol_count, symbolSection) ||
+      !reader.readSection<StringRef>(header.synonym_count, synonymSection) ||
+      !reader.readSection<uint32_t>(header.symbol_ref_count, symbolRefSection) ||
+      !reader.readSection<char>(header.arena_size, arena) || !reader.atEnd()) {
+    LOGW("Cache image is truncated.");
+    return false;
+  }
+
+  const std::span<const char> body{itemSection.data(),
+                                   static_cast<size_t>(arena.data() + arena.size() -
+                                                       itemSection.data())};
+  if (checksum(body) != header.checksum) {
+    LOGW("Cache image is corrupted.");
+    return false;
+  }
+
+  const auto string = [&arena](const StringRef& ref) {
+    if (ref.offset > arena.size() || ref.length > arena.size() - ref.offset) return std::string{};
+    return std::string{arena.data() + ref.offset, ref.length};
+  };
+
+  std::vector<Symbol> symbols;
+  symbols.reserve(header.symbol_count);
+  for (size_t i = 0; i < header.symbol_count; ++i) {
+    symbols.push_back(anime::symbols.intern(string(recordAt<StringRef>(symbolSection, i))));
+  }
+
+  const auto symbolList = [&](const ListRef& ref, std::vector<Symbol>& values) {
+    if (ref.first > header.symbol_ref_count || ref.count > header.symbol_ref_count - ref.first) {
+      return;
+    }
+    values.reserve(ref.count);
+    for (size_t i = ref.first; i < ref.first + ref.count; ++i) {
+      const auto index = recordAt<uint32_t>(symbolRefSection, i);
+      if (index < symbols.size()) values.push_back(symbols[index]);
+    }
+  };
+
+  items.reserve(items.size() + header.item_count);
+  for (size_t i = 0; i < header.item_count; ++i) {
+    const auto record = recordAt<ItemRecord>(itemSection, i);
+    auto& item = items.emplace_back(Anime{
+        .id = record.id,
+        .last_modified = record.last_modified,
+        .episode_count = record.episode_count,
+        .episode_length = record.episode_length,
+        .age_rating = static_cast<AgeRating>(record.age_rating),
+        .status = static_cast<Status>(record.status),
+        .type = static_cast<Type>(record.type),
+        .date_started = unpackDate(record.date_started),
+        .date_finished = unpackDate(record.date_finished),
+        .score = record.score,
+        .popularity_rank = record.popularity_rank,
+        .titles{
+            .romaji = string(record.romaji),
+            .english = string(record.english),
+            .japanese = string(record.japanese),
+        },
+        .last_aired_episode = record.last_aired_episode,
+        .next_episode_time = record.next_episode_time,
+    });
+    if (record.synonyms.first <= header.synonym_count &&
+        record.synonyms.count <= header.synonym_count - record.synonyms.first) {
+      item.titles.synonyms.reserve(record.synonyms.count);
+      for (size_t j = record.synonyms.first; j < record.synonyms.first + record.synonyms.count;
+           ++j) {
+        item.titles.synonyms.push_back(string(recordAt<StringRef>(synonymSection, j)));
+      }
+    }
+    symbolList(record.genres, item.genres);
+    symbolList(record.producers, item.producers);
+    symbolList(record.studios, item.studios);
+    symbolList(record.tags, item.tags);
+  }
+
+  entries.reserve(entries.size() + header.entry_count);
+  for (size_t i = 0; i < header.entry_count; ++i) {
+    const auto record = recordAt<EntryRecord>(entrySection, i);
+    entries.push_back({
+        .id = record.id,
+        .anime_id = record.anime_id,
+        .watched_episodes = record.watched_episodes,
+        .score = record.score,
+        .status = static_cast<list::Status>(record.status),
+        .is_private = record.is_private != 0,
+        .rewatched_times = record.rewatched_times,
+        .rewatching = record.rewatching != 0,
+        .rewatching_ep = record.rewatching_ep,
+        .date_started = unpackDate(record.date_started),
+        .date_completed = unpackDate(record.date_completed),
+        .last_updated = record.last_updated,
+        .notes = string(record.notes),
+    });
+  }
+
+  return true;
+}
+
+}  // namespace anime::cache
@@ -0,0 +1,53 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2024, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QString>
+#include <compare>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "base/flat_store.hpp"
+#include "media/anime.hpp"
+#include "media/anime_list.hpp"
+
+namespace anime::cache {
+
+// Identifies the state of the database file that a cache image was written for
+struct Stamp {
+  int64_t modified = 0;
+  int64_t size = 0;
+
+  bool operator==(const Stamp&) const = default;
+};
+
+// Returns `std::nullopt` if the database has changes that are not yet checkpointed into the main
+// file, in which case the file alone doesn't tell us whether a cache image is up to date.
+std::optional<Stamp> databaseStamp(const QString& fileName);
+
+// A cache image is a compact, fixed-layout copy of the items and entries that are stored in the
+// database, which can be read much faster than decoding the same rows from SQLite. It is only
+// valid for the database state and schema version that it was written for.
+bool write(const QString& fileName, const Stamp& stamp, const int schemaVersion,
+           const base::FlatStore<Anime>& items, const base::FlatStore<ListEntry>& entries);
+bool read(const QString& fileName, const Stamp& stamp, const int schemaVersion,
+          std::vector<Anime>& items, std::vector<ListEntry>& entries);
+
+}  // namespace anime::cache
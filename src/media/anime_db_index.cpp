@@ -0,0 +1,134 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2024, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "anime_db_index.hpp"
+
+namespace anime {
+
+void DatabaseIndex::insertItem(const Anime& item) {
+  const ItemKeys keys{
+      .year = item.date_started.year(),
+      .season = static_cast<int>(Season{item.date_started}.name),
+      .type = static_cast<int>(item.type),
+      .status = static_cast<int>(item.status),
+  };
+
+  const auto it = itemKeys_.constFind(item.id);
+
+  if (it == itemKeys_.cend()) {
+    years_[keys.year].insert(item.id);
+    seasons_[keys.season].insert(item.id);
+    types_[keys.type].insert(item.id);
+    statuses_[keys.status].insert(item.id);
+  } else {
+    if (*it == keys) return;
+    move(years_, item.id, it->year, keys.year);
+    move(seasons_, item.id, it->season, keys.season);
+    move(types_, item.id, it->type, keys.type);
+    move(statuses_, item.id, it->status, keys.status);
+  }
+
+  itemKeys_.insert(item.id, keys);
+  ++generation_;
+}
+
+void DatabaseIndex::insertEntry(const ListEntry& entry) {
+  const int id = entry.anime_id;
+  const int status = static_cast<int>(entry.status);
+
+  const auto it = entryKeys_.constFind(id);
+
+  if (it == entryKeys_.cend()) {
+    listStatuses_[status].insert(id);
+  } else {
+    if (*it == status) return;
+    move(listStatuses_, id, *it, status);
+  }
+
+  if (entry.status != list::Status::NotInList) {
+    listed_.insert(id);
+  } else {
+    listed_.remove(id);
+  }
+
+  entryKeys_.insert(id, status);
+  ++generation_;
+}
+
+void DatabaseIndex::removeEntry(const ListEntry& entry) {
+  const int id = entry.anime_id;
+
+  const auto it = entryKeys_.constFind(id);
+  if (it == entryKeys_.cend()) return;
+
+  if (auto postings = listStatuses_.find(*it); postings != listStatuses_.end()) {
+    postings->remove(id);
+    if (postings->isEmpty()) listStatuses_.erase(postings);
+  }
+
+  listed_.remove(id);
+  entryKeys_.erase(it);
+  ++generation_;
+}
+
+size_t DatabaseIndex::generation() const {
+  return generation_;
+}
+
+const QSet<int>& DatabaseIndex::itemsByYear(const int year) const {
+  return postings(years_, year);
+}
+
+const QSet<int>& DatabaseIndex::itemsBySeason(const SeasonName season) const {
+  return postings(seasons_, static_cast<int>(season));
+}
+
+const QSet<int>& DatabaseIndex::itemsByType(const Type type) const {
+  return postings(types_, static_cast<int>(type));
+}
+
+const QSet<int>& DatabaseIndex::itemsByStatus(const Status status) const {
+  return postings(statuses_, static_cast<int>(status));
+}
+
+const QSet<int>& DatabaseIndex::itemsByListStatus(const list::Status status) const {
+  return postings(listStatuses_, static_cast<int>(status));
+}
+
+const QSet<int>& DatabaseIndex::itemsInList() const {
+  return listed_;
+}
+
+const QSet<int>& DatabaseIndex::postings(const Postings& index, const int key) {
+  static const QSet<int> empty;
+  const auto it = index.constFind(key);
+  return it != index.cend() ? *it : empty;
+}
+
+void DatabaseIndex::move(Postings& index, const int id, const int from, const int to) {
+  if (from == to) return;
+
+  if (auto it = index.find(from); it != index.end()) {
+    it->remove(id);
+    if (it->isEmpty()) index.erase(it);
+  }
+
+  index[to].insert(id);
+}
+
+}  // namespace anime
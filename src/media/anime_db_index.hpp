@@ -0,0 +1,80 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2024, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QSet>
+
+#include "media/anime.hpp"
+#include "media/anime_list.hpp"
+#include "media/anime_season.hpp"
+
+namespace anime {
+
+// Maps the values of commonly filtered fields to the ids of the items that have them, so that
+// filters can be answered by intersecting sets rather than by looking at every item. The index
+// is kept up to date by `Database` as items and entries change.
+class DatabaseIndex final {
+public:
+  void insertItem(const Anime& item);
+  void insertEntry(const ListEntry& entry);
+  void removeEntry(const ListEntry& entry);
+
+  // Incremented on every change, so that results that are derived from the index can tell when
+  // they are out of date
+  size_t generation() const;
+
+  const QSet<int>& itemsByYear(const int year) const;
+  const QSet<int>& itemsBySeason(const SeasonName season) const;
+  const QSet<int>& itemsByType(const Type type) const;
+  const QSet<int>& itemsByStatus(const Status status) const;
+  const QSet<int>& itemsByListStatus(const list::Status status) const;
+
+  // Items with a list entry in any status
+  const QSet<int>& itemsInList() const;
+
+private:
+  struct ItemKeys {
+    int year = 0;
+    int season = 0;
+    int type = 0;
+    int status = 0;
+
+    bool operator==(const ItemKeys&) const = default;
+  };
+
+  using Postings = QHash<int, QSet<int>>;
+
+  static const QSet<int>& postings(const Postings& index, const int key);
+  static void move(Postings& index, const int id, const int from, const int to);
+
+  size_t generation_ = 0;
+
+  QHash<int, ItemKeys> itemKeys_;
+  QHash<int, int> entryKeys_;
+
+  Postings years_;
+  Postings seasons_;
+  Postings types_;
+  Postings statuses_;
+  Postings listStatuses_;
+  QSet<int> listed_;
+};
+
+}  // namespace anime
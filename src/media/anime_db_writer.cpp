@@ -0,0 +1,142 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2024, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "anime_db_writer.hpp"
+
+#include <QElapsedTimer>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QVariant>
+
+#include "base/log.hpp"
+
+namespace {
+
+constexpr auto kWriterConnectionName = "writer";
+
+// Entries that were added here have no id until they are synced, and are stored with a NULL id
+QVariant listIdValue(const int64_t id) {
+  if (id == anime::list::kUnknownId) return QVariant{QMetaType::fromType<qint64>()};
+  return QVariant{static_cast<qint64>(id)};
+}
+
+void bindEntryToQuery(const ListEntry& entry, QSqlQuery& q) {
+  q.bindValue(":id", listIdValue(entry.id));
+  q.bindValue(":media_id", entry.anime_id);
+  q.bindValue(":progress", entry.watched_episodes);
+  q.bindValue(":date_start", QString::fromStdString(entry.date_started.to_string()));
+  q.bindValue(":date_end", QString::fromStdString(entry.date_completed.to_string()));
+  q.bindValue(":score", entry.score);
+  q.bindValue(":status", static_cast<int>(entry.status));
+  q.bindValue(":private", entry.is_private);
+  q.bindValue(":rewatched_times", entry.rewatched_times);
+  q.bindValue(":rewatching", entry.rewatching);
+  q.bindValue(":rewatching_ep", entry.rewatching_ep);
+  q.bindValue(":notes", QString::fromStdString(entry.notes));
+  q.bindValue(":last_updated", QString::number(entry.last_updated));
+}
+
+}  // namespace
+
+namespace anime {
+
+DatabaseWriter::DatabaseWriter(const QString& fileName, base::SqlStatementCache::loader_t loader)
+    : QObject{}, fileName_{fileName}, statements_{std::move(loader)} {}
+
+void DatabaseWriter::open() {
+  db_ = QSqlDatabase::addDatabase("QSQLITE", kWriterConnectionName);
+  db_.setDatabaseName(fileName_);
+
+  if (!db_.open()) {
+    LOGE("{}", db_.lastError().text().toStdString());
+    return;
+  }
+
+  // The main connection may be holding the write lock while it's updating items
+  QSqlQuery q{db_};
+  q.exec("PRAGMA busy_timeout = 5000");
+  q.exec("PRAGMA synchronous = NORMAL");
+
+  statements_.setDatabase(db_);
+}
+
+void DatabaseWriter::close() {
+  statements_.clear();
+
+  if (db_.isOpen()) db_.close();
+  db_ = {};
+
+  QSqlDatabase::removeDatabase(kWriterConnectionName);
+}
+
+bool DatabaseWriter::writeEntries(const std::vector<ListEntry>& entries,
+                                  const std::vector<list::Tombstone>& tombstones) {
+  if (!db_.isOpen()) return false;
+
+  const auto insertEntry = statements_.get("insertAnimeList");
+  const auto deleteEntry = statements_.get("deleteAnimeList");
+  const auto insertTombstone = statements_.get("insertAnimeListTombstone");
+  const auto deleteTombstone = statements_.get("deleteAnimeListTombstone");
+  if (!insertEntry || !deleteEntry || !insertTombstone || !deleteTombstone) return false;
+
+  QElapsedTimer timer;
+  timer.start();
+
+  if (!db_.transaction()) {
+    LOGE("{}", db_.lastError().text().toStdString());
+    return false;
+  }
+
+  // A batch is written as a whole or not at all
+  const auto exec = [this](QSqlQuery& q) {
+    if (q.exec()) return true;
+    LOGE("{}", q.lastError().text().toStdString());
+    db_.rollback();
+    return false;
+  };
+
+  for (const auto& entry : entries) {
+    bindEntryToQuery(entry, *insertEntry);
+    if (!exec(*insertEntry)) return false;
+    // An entry that is added again is no longer removed
+    deleteTombstone->bindValue(":media_id", entry.anime_id);
+    if (!exec(*deleteTombstone)) return false;
+  }
+
+  for (const auto& tombstone : tombstones) {
+    deleteEntry->bindValue(":media_id", tombstone.anime_id);
+    if (!exec(*deleteEntry)) return false;
+    insertTombstone->bindValue(":media_id", tombstone.anime_id);
+    insertTombstone->bindValue(":id", listIdValue(tombstone.id));
+    insertTombstone->bindValue(":removed_at", static_cast<qint64>(tombstone.removed_at));
+    if (!exec(*insertTombstone)) return false;
+  }
+
+  if (!db_.commit()) {
+    LOGE("{}", db_.lastError().text().toStdString());
+    db_.rollback();
+    return false;
+  }
+
+  LOGD("Wrote {} list entries and {} tombstones in {} ms.", entries.size(), tombstones.size(),
+       timer.elapsed());
+
+  return true;
+}
+
+}  // namespace anime
@@ -0,0 +1,58 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2024, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QSqlDatabase>
+#include <QString>
+#include <vector>
+
+#include "base/sql.hpp"
+#include "media/anime_list.hpp"
+
+namespace anime {
+
+// Writes list entries and tombstones on a thread of its own, with a separate connection. Batches
+// are written in the order in which they are submitted, each in a single transaction, so that
+// the file on disk always matches some earlier state of the in-memory list.
+//
+// The writer must be moved to its thread before `open()`, and all of its functions must be
+// called from that thread.
+class DatabaseWriter final : public QObject {
+  Q_OBJECT
+  Q_DISABLE_COPY_MOVE(DatabaseWriter)
+
+public:
+  DatabaseWriter(const QString& fileName, base::SqlStatementCache::loader_t loader);
+  ~DatabaseWriter() = default;
+
+  void open();
+  void close();
+
+  // Returns false if the batch could not be written, in which case nothing has been written
+  bool writeEntries(const std::vector<ListEntry>& entries,
+                    const std::vector<list::Tombstone>& tombstones);
+
+private:
+  QString fileName_;
+  QSqlDatabase db_;
+  base::SqlStatementCache statements_;
+};
+
+}  // namespace anime
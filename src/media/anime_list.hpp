@@ -19,6 +19,7 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <string>
 
 #include "base/chrono.hpp"
@@ -63,6 +64,42 @@ struct Entry {
   std::string notes;
 };
 
+// Left behind by a removed entry, so that a later sync can tell it apart from an entry that was
+// never added
+struct Tombstone {
+  int anime_id = kUnknownId;
+  int64_t id = kUnknownId;
+  std::time_t removed_at = 0;
+};
+
+// Aggregates over the whole list. The same type is used for the changes that are made to them,
+// in which case the values may be negative.
+struct Statistics {
+  std::array<int, 6> counts{};  // indexed by `Status`
+  int episodes = 0;
+  int minutes = 0;
+
+  int count(const Status status) const {
+    return counts[static_cast<size_t>(status)];
+  }
+
+  Statistics& operator+=(const Statistics& other) {
+    for (size_t i = 0; i < counts.size(); ++i) counts[i] += other.counts[i];
+    episodes += other.episodes;
+    minutes += other.minutes;
+    return *this;
+  }
+
+  Statistics& operator-=(const Statistics& other) {
+    for (size_t i = 0; i < counts.size(); ++i) counts[i] -= other.counts[i];
+    episodes -= other.episodes;
+    minutes -= other.minutes;
+    return *this;
+  }
+
+  bool operator==(const Statistics&) const = default;
+};
+
 }  // namespace anime::list
 
 using ListEntry = anime::list::Entry;
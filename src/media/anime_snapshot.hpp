@@ -0,0 +1,59 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2024, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "base/persistent_map.hpp"
+#include "media/anime.hpp"
+#include "media/anime_list.hpp"
+
+namespace anime {
+
+// An immutable view of the database at some point in time, which can be held and read from any
+// thread while the database keeps changing. Items don't carry their extras.
+class Snapshot final {
+public:
+  using items_t = base::PersistentMap<Anime, &Anime::id>;
+  using entries_t = base::PersistentMap<ListEntry, &ListEntry::anime_id>;
+
+  Snapshot() = default;
+  Snapshot(items_t items, entries_t entries)
+      : items_{std::move(items)}, entries_{std::move(entries)} {}
+
+  const Anime* item(const int id) const {
+    return items_.find(id);
+  }
+
+  const ListEntry* entry(const int id) const {
+    return entries_.find(id);
+  }
+
+  const items_t& items() const {
+    return items_;
+  }
+
+  const entries_t& entries() const {
+    return entries_;
+  }
+
+private:
+  items_t items_;
+  entries_t entries_;
+};
+
+}  // namespace anime
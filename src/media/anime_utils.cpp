@@ -24,6 +24,7 @@
 
 #include "base/chrono.hpp"
 #include "media/anime.hpp"
+#include "media/anime_db.hpp"
 
 namespace {
 
@@ -150,15 +151,16 @@ bool isNsfw(const Details& item) {
   if (item.age_rating == anime::AgeRating::R18) return true;
 
   if (item.age_rating == anime::AgeRating::Unknown) {
-    if (std::ranges::contains(item.genres, "Hentai")) return true;
+    static const auto hentai = symbols.intern("Hentai");
+    if (std::ranges::contains(item.genres, hentai)) return true;
   }
 
   return false;
 }
 
-bool isStale(const Details& item) {
+bool isStale(const Details& item, const Extras& extras) {
   if (!item.last_modified) return true;
-  if (item.synopsis.empty()) return true;
+  if (extras.synopsis.empty()) return true;
   if (item.genres.empty()) return true;
   if (item.score == kUnknownScore && isAiredYet(item)) return true;
 
@@ -32,6 +32,7 @@ int estimateEpisodeLength(const Details& item);
 int estimateLastAiredEpisodeNumber(const Details& item);
 
 bool isNsfw(const Details& item);
-bool isStale(const Details& item);
+// Extras are not resident in the database, so they are passed by the caller who has read them
+bool isStale(const Details& item, const Extras& extras);
 
 }  // namespace anime
@@ -0,0 +1 @@
+DELETE FROM anime_list WHERE media_id = :media_id
@@ -0,0 +1 @@
+DELETE FROM anime_list_tombstone WHERE media_id = :media_id
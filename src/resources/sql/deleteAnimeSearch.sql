@@ -0,0 +1 @@
+DELETE FROM anime_search WHERE rowid = :id
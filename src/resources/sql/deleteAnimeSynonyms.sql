@@ -0,0 +1 @@
+DELETE FROM anime_synonym WHERE anime_id = :anime_id
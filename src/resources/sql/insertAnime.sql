@@ -4,7 +4,6 @@ INSERT OR REPLACE INTO
     title,
     english,
     japanese,
-    synonym,
     type,
     status,
     episode_count,
@@ -12,12 +11,9 @@ INSERT OR REPLACE INTO
     date_start,
     date_end,
     image,
+    slug,
     trailer_id,
     age_rating,
-    genres,
-    tags,
-    producers,
-    studios,
     score,
     popularity,
     synopsis,
@@ -30,7 +26,6 @@ INSERT OR REPLACE INTO
     :title,
     :english,
     :japanese,
-    :synonym,
     :type,
     :status,
     :episode_count,
@@ -38,12 +33,9 @@ INSERT OR REPLACE INTO
     :date_start,
     :date_end,
     :image,
+    :slug,
     :trailer_id,
     :age_rating,
-    :genres,
-    :tags,
-    :producers,
-    :studios,
     :score,
     :popularity,
     :synopsis,
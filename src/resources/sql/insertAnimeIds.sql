@@ -0,0 +1,11 @@
+INSERT OR REPLACE INTO
+  anime_ids(
+    service,
+    service_id,
+    anime_id
+  )
+  VALUES(
+    :service,
+    :service_id,
+    :anime_id
+  )
@@ -1,4 +1,4 @@
-INSERT OR REPLACE INTO
+INSERT INTO
   anime_list(
     id,
     media_id,
@@ -29,3 +29,16 @@ INSERT OR REPLACE INTO
     :notes,
     :last_updated
   )
+  ON CONFLICT(media_id) DO UPDATE SET
+    id = excluded.id,
+    progress = excluded.progress,
+    date_start = excluded.date_start,
+    date_end = excluded.date_end,
+    score = excluded.score,
+    status = excluded.status,
+    private = excluded.private,
+    rewatched_times = excluded.rewatched_times,
+    rewatching = excluded.rewatching,
+    rewatching_ep = excluded.rewatching_ep,
+    notes = excluded.notes,
+    last_updated = excluded.last_updated
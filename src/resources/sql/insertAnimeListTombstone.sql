@@ -0,0 +1,11 @@
+INSERT OR REPLACE INTO
+  anime_list_tombstone(
+    media_id,
+    id,
+    removed_at
+  )
+  VALUES(
+    :media_id,
+    :id,
+    :removed_at
+  )
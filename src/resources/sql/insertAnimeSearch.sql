@@ -0,0 +1,17 @@
+INSERT INTO
+  anime_search(
+    rowid,
+    title,
+    english,
+    japanese,
+    synonyms,
+    synopsis
+  )
+  VALUES(
+    :id,
+    :title,
+    :english,
+    :japanese,
+    :synonyms,
+    :synopsis
+  )
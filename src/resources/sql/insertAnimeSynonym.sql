@@ -0,0 +1,11 @@
+INSERT INTO
+  anime_synonym(
+    anime_id,
+    position,
+    title
+  )
+  VALUES(
+    :anime_id,
+    :position,
+    :title
+  )
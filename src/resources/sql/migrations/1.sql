@@ -1,3 +1,11 @@
+-- Initial schema
+
+CREATE TABLE IF NOT EXISTS meta(
+  id INTEGER PRIMARY KEY,
+  name TEXT,
+  value TEXT
+);
+
 CREATE TABLE IF NOT EXISTS anime(
   id INTEGER PRIMARY KEY,
   title TEXT,
@@ -24,3 +32,20 @@ CREATE TABLE IF NOT EXISTS anime(
   next_episode_time TEXT,
   modified TEXT
 );
+
+CREATE TABLE IF NOT EXISTS anime_list(
+  id INTEGER PRIMARY KEY,
+  media_id INTEGER NOT NULL,
+  progress INTEGER,
+  date_start TEXT,
+  date_end TEXT,
+  score INTEGER,
+  status INTEGER,
+  private INTEGER,
+  rewatched_times INTEGER,
+  rewatching INTEGER,
+  rewatching_ep INTEGER,
+  notes TEXT,
+  last_updated TEXT,
+  FOREIGN KEY (media_id) REFERENCES media (id)
+);
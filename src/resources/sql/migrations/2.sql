@@ -0,0 +1,183 @@
+-- Move comma-joined lists into join tables, and store numeric values with
+-- their actual types.
+
+CREATE TABLE anime_synonym(
+  anime_id INTEGER NOT NULL,
+  position INTEGER NOT NULL,
+  title TEXT NOT NULL,
+  PRIMARY KEY (anime_id, position)
+) WITHOUT ROWID;
+
+CREATE TABLE genre(
+  id INTEGER PRIMARY KEY,
+  name TEXT NOT NULL UNIQUE
+);
+
+CREATE TABLE anime_genre(
+  anime_id INTEGER NOT NULL,
+  genre_id INTEGER NOT NULL,
+  position INTEGER NOT NULL,
+  PRIMARY KEY (anime_id, genre_id)
+) WITHOUT ROWID;
+
+CREATE INDEX anime_genre_genre_id ON anime_genre(genre_id, anime_id);
+
+CREATE TABLE producer(
+  id INTEGER PRIMARY KEY,
+  name TEXT NOT NULL UNIQUE
+);
+
+CREATE TABLE anime_producer(
+  anime_id INTEGER NOT NULL,
+  producer_id INTEGER NOT NULL,
+  position INTEGER NOT NULL,
+  PRIMARY KEY (anime_id, producer_id)
+) WITHOUT ROWID;
+
+CREATE INDEX anime_producer_producer_id ON anime_producer(producer_id, anime_id);
+
+CREATE TABLE studio(
+  id INTEGER PRIMARY KEY,
+  name TEXT NOT NULL UNIQUE
+);
+
+CREATE TABLE anime_studio(
+  anime_id INTEGER NOT NULL,
+  studio_id INTEGER NOT NULL,
+  position INTEGER NOT NULL,
+  PRIMARY KEY (anime_id, studio_id)
+) WITHOUT ROWID;
+
+CREATE INDEX anime_studio_studio_id ON anime_studio(studio_id, anime_id);
+
+CREATE TABLE tag(
+  id INTEGER PRIMARY KEY,
+  name TEXT NOT NULL UNIQUE
+);
+
+CREATE TABLE anime_tag(
+  anime_id INTEGER NOT NULL,
+  tag_id INTEGER NOT NULL,
+  position INTEGER NOT NULL,
+  PRIMARY KEY (anime_id, tag_id)
+) WITHOUT ROWID;
+
+CREATE INDEX anime_tag_tag_id ON anime_tag(tag_id, anime_id);
+
+-- Split the old ", "-joined values into rows
+
+CREATE TEMP TABLE split_value(
+  anime_id INTEGER,
+  kind TEXT,
+  position INTEGER,
+  value TEXT
+);
+
+WITH RECURSIVE split(anime_id, kind, position, value, rest) AS (
+  SELECT id, 'synonym', -1, '', synonym || ', ' FROM anime WHERE synonym <> ''
+  UNION ALL
+  SELECT id, 'genre', -1, '', genres || ', ' FROM anime WHERE genres <> ''
+  UNION ALL
+  SELECT id, 'producer', -1, '', producers || ', ' FROM anime WHERE producers <> ''
+  UNION ALL
+  SELECT id, 'studio', -1, '', studios || ', ' FROM anime WHERE studios <> ''
+  UNION ALL
+  SELECT id, 'tag', -1, '', tags || ', ' FROM anime WHERE tags <> ''
+  UNION ALL
+  SELECT
+    anime_id,
+    kind,
+    position + 1,
+    substr(rest, 1, instr(rest, ', ') - 1),
+    substr(rest, instr(rest, ', ') + 2)
+  FROM split
+  WHERE rest <> ''
+)
+INSERT INTO split_value
+  SELECT anime_id, kind, position, value FROM split WHERE position >= 0 AND value <> '';
+
+INSERT INTO anime_synonym(anime_id, position, title)
+  SELECT anime_id, position, value FROM split_value WHERE kind = 'synonym';
+
+INSERT OR IGNORE INTO genre(name)
+  SELECT value FROM split_value WHERE kind = 'genre';
+INSERT OR IGNORE INTO anime_genre(anime_id, genre_id, position)
+  SELECT s.anime_id, t.id, s.position FROM split_value s JOIN genre t ON t.name = s.value
+  WHERE s.kind = 'genre';
+
+INSERT OR IGNORE INTO producer(name)
+  SELECT value FROM split_value WHERE kind = 'producer';
+INSERT OR IGNORE INTO anime_producer(anime_id, producer_id, position)
+  SELECT s.anime_id, t.id, s.position FROM split_value s JOIN producer t ON t.name = s.value
+  WHERE s.kind = 'producer';
+
+INSERT OR IGNORE INTO studio(name)
+  SELECT value FROM split_value WHERE kind = 'studio';
+INSERT OR IGNORE INTO anime_studio(anime_id, studio_id, position)
+  SELECT s.anime_id, t.id, s.position FROM split_value s JOIN studio t ON t.name = s.value
+  WHERE s.kind = 'studio';
+
+INSERT OR IGNORE INTO tag(name)
+  SELECT value FROM split_value WHERE kind = 'tag';
+INSERT OR IGNORE INTO anime_tag(anime_id, tag_id, position)
+  SELECT s.anime_id, t.id, s.position FROM split_value s JOIN tag t ON t.name = s.value
+  WHERE s.kind = 'tag';
+
+DROP TABLE split_value;
+
+-- Rebuild the anime table without the list columns, and with typed values
+
+CREATE TABLE anime_new(
+  id INTEGER PRIMARY KEY,
+  title TEXT,
+  english TEXT,
+  japanese TEXT,
+  type INTEGER,
+  status INTEGER,
+  episode_count INTEGER,
+  episode_length INTEGER,
+  date_start TEXT,
+  date_end TEXT,
+  image TEXT,
+  trailer_id TEXT,
+  age_rating INTEGER,
+  score REAL,
+  popularity INTEGER,
+  synopsis TEXT,
+  last_aired_episode INTEGER,
+  next_episode_time INTEGER,
+  modified INTEGER
+);
+
+INSERT INTO anime_new
+  SELECT
+    id,
+    title,
+    english,
+    japanese,
+    type,
+    status,
+    episode_count,
+    episode_length,
+    date_start,
+    date_end,
+    image,
+    trailer_id,
+    age_rating,
+    CAST(score AS REAL),
+    popularity,
+    synopsis,
+    last_aired_episode,
+    CAST(next_episode_time AS INTEGER),
+    CAST(modified AS INTEGER)
+  FROM anime;
+
+DROP TABLE anime;
+
+ALTER TABLE anime_new RENAME TO anime;
+
+CREATE INDEX anime_type ON anime(type);
+CREATE INDEX anime_status ON anime(status);
+CREATE INDEX anime_date_start ON anime(date_start);
+CREATE INDEX anime_list_media_id ON anime_list(media_id);
+CREATE INDEX anime_list_status ON anime_list(status);
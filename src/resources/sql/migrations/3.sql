@@ -0,0 +1,3 @@
+-- Store the slug along with the other fields that are loaded on demand.
+
+ALTER TABLE anime ADD COLUMN slug TEXT;
@@ -0,0 +1,26 @@
+-- Full-text index over titles, synonyms and synopses. The trigram tokenizer
+-- allows matching any substring of at least three characters.
+
+CREATE VIRTUAL TABLE anime_search USING fts5(
+  title,
+  english,
+  japanese,
+  synonyms,
+  synopsis,
+  tokenize = 'trigram'
+);
+
+INSERT INTO anime_search(rowid, title, english, japanese, synonyms, synopsis)
+  SELECT
+    id,
+    title,
+    english,
+    japanese,
+    (
+      SELECT group_concat(s.title, char(10))
+      FROM (
+        SELECT title FROM anime_synonym WHERE anime_id = anime.id ORDER BY position
+      ) s
+    ),
+    synopsis
+  FROM anime;
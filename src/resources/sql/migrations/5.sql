@@ -0,0 +1,8 @@
+-- Removed list entries leave a tombstone behind, so that a later sync can tell
+-- an entry that was removed here apart from one that was never added.
+
+CREATE TABLE anime_list_tombstone(
+  media_id INTEGER PRIMARY KEY,
+  id INTEGER,
+  removed_at INTEGER NOT NULL
+);
@@ -0,0 +1,11 @@
+-- Ids of items on each service, so that switching services or importing a list can map ids
+-- locally. `service` is the slug of the service, and `anime_id` is the id of the item here.
+
+CREATE TABLE anime_ids(
+  service TEXT NOT NULL,
+  service_id INTEGER NOT NULL,
+  anime_id INTEGER NOT NULL,
+  PRIMARY KEY (service, service_id)
+) WITHOUT ROWID;
+
+CREATE UNIQUE INDEX anime_ids_anime_id ON anime_ids(anime_id, service);
@@ -0,0 +1,44 @@
+-- Key list entries by their item. Entries that don't have an id on the service
+-- yet used to be written with id 0, where each of them replaced the one before.
+-- The id is now NULL until it's known. Where an item has several rows, the one
+-- that was updated last is kept.
+
+CREATE TABLE anime_list_new(
+  media_id INTEGER PRIMARY KEY,
+  id INTEGER,
+  progress INTEGER,
+  date_start TEXT,
+  date_end TEXT,
+  score INTEGER,
+  status INTEGER,
+  private INTEGER,
+  rewatched_times INTEGER,
+  rewatching INTEGER,
+  rewatching_ep INTEGER,
+  notes TEXT,
+  last_updated TEXT
+);
+
+INSERT OR REPLACE INTO anime_list_new
+  SELECT
+    media_id,
+    NULLIF(id, 0),
+    progress,
+    date_start,
+    date_end,
+    score,
+    status,
+    private,
+    rewatched_times,
+    rewatching,
+    rewatching_ep,
+    notes,
+    last_updated
+  FROM anime_list
+  ORDER BY CAST(last_updated AS INTEGER), id;
+
+DROP TABLE anime_list;
+
+ALTER TABLE anime_list_new RENAME TO anime_list;
+
+CREATE INDEX anime_list_status ON anime_list(status);
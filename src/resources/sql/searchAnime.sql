@@ -0,0 +1,5 @@
+SELECT rowid
+FROM anime_search
+WHERE anime_search MATCH :query
+ORDER BY bm25(anime_search, 10.0, 10.0, 10.0, 5.0, 1.0)
+LIMIT :limit
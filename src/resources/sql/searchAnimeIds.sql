@@ -0,0 +1,4 @@
+SELECT rowid
+FROM anime_search
+WHERE anime_search MATCH :query
+  AND rowid IN (SELECT value FROM json_each(:ids))
@@ -0,0 +1,19 @@
+SELECT
+  id,
+  title,
+  english,
+  japanese,
+  type,
+  status,
+  episode_count,
+  episode_length,
+  date_start,
+  date_end,
+  age_rating,
+  score,
+  popularity,
+  last_aired_episode,
+  next_episode_time,
+  modified
+FROM anime
+ORDER BY id
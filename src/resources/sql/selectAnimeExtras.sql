@@ -0,0 +1,7 @@
+SELECT
+  image,
+  slug,
+  synopsis,
+  trailer_id
+FROM anime
+WHERE id = :id
@@ -0,0 +1,6 @@
+SELECT
+  service_id,
+  anime_id
+FROM anime_ids
+WHERE service = :service
+  AND service_id IN (SELECT value FROM json_each(:ids))
@@ -0,0 +1,15 @@
+SELECT
+  id,
+  media_id,
+  progress,
+  date_start,
+  date_end,
+  score,
+  status,
+  private,
+  rewatched_times,
+  rewatching,
+  rewatching_ep,
+  notes,
+  last_updated
+FROM anime_list
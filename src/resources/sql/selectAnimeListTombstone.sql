@@ -0,0 +1,4 @@
+SELECT
+  removed_at
+FROM anime_list_tombstone
+WHERE media_id = :media_id
@@ -0,0 +1,6 @@
+SELECT
+  anime_id,
+  service_id
+FROM anime_ids
+WHERE service = :service
+  AND anime_id IN (SELECT value FROM json_each(:ids))
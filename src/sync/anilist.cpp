@@ -23,6 +23,7 @@
 #include <QJsonObject>
 #include <QRestReply>
 #include <ranges>
+#include <vector>
 
 #include "base/file.hpp"
 #include "base/log.hpp"
@@ -95,7 +96,8 @@ void Service::fetchAnime(const int id) {
       return;
     }
 
-    const auto item = reply.readJson().and_then(
+    const auto json = reply.readJson();
+    const auto item = json.and_then(
         [](const QJsonDocument& json) { return parseMedia(json["data"]["Media"]); });
 
     if (!item) {
@@ -104,6 +106,7 @@ void Service::fetchAnime(const int id) {
     }
 
     anime::db.updateItem(*item);
+    anime::db.updateUids(parseMediaUids((*json)["data"]["Media"]));
   };
 
   manager_.post(api_.createRequest(), data, this, callback);
@@ -121,7 +124,8 @@ void Service::search(const QString& query) {
       return;
     }
 
-    const auto items = reply.readJson().and_then([](const QJsonDocument& json) {
+    const auto json = reply.readJson();
+    const auto items = json.and_then([](const QJsonDocument& json) {
       const auto value = json["data"]["Page"]["media"];
       if (!value.isArray()) return std::optional<QList<std::optional<Anime>>>{};
       return std::make_optional(value.toArray() | std::views::transform(parseMedia) |
@@ -133,9 +137,15 @@ void Service::search(const QString& query) {
       return;
     }
 
-    for (const auto& item : *items) {
-      if (item) anime::db.updateItem(*item);
-    }
+    const auto parsedItems = *items |
+                             std::views::filter([](const auto& item) { return item.has_value(); }) |
+                             std::views::transform([](const auto& item) { return *item; }) |
+                             std::ranges::to<std::vector>();
+
+    anime::db.updateItems(parsedItems);
+    anime::db.updateUids((*json)["data"]["Page"]["media"].toArray() |
+                         std::views::transform(parseMediaUids) | std::views::join |
+                         std::ranges::to<std::vector>());
   };
 
   manager_.post(api_.createRequest(), data, this, callback);
@@ -159,13 +169,13 @@ void Service::deleteListEntry(const int id) {
       {"variables", QJsonObject{{"id", listEntry->id}}},
   }};
 
-  const auto callback = [this](QRestReply& reply) {
+  const auto callback = [this, id](QRestReply& reply) {
     if (isError(reply) && reply.httpStatus() != 404) {
       handleError(reply);
       return;
     }
 
-    // @TODO: anime::db.deleteEntry(id);
+    anime::db.removeEntry(id);
   };
 
   manager_.post(api_.createRequest(), data, this, callback);
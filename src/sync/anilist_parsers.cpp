@@ -31,6 +31,7 @@
 #include "media/anime.hpp"
 #include "media/anime_list.hpp"
 #include "media/anime_season.hpp"
+#include "sync/service.hpp"
 
 namespace sync::anilist {
 
@@ -107,8 +108,6 @@ std::optional<Anime> parseMedia(const QJsonValue& json) {
       .date_finished = parseFuzzyDate(json["endDate"]),
       .score = parseScore(json["averageScore"].toInt()),
       .popularity_rank = json["popularity"].toInt(),
-      .image_url = json["coverImage"]["extraLarge"].toString().toStdString(),
-      .synopsis = json["description"].toString().toStdString(),
       .titles{
           .romaji = json["title"]["romaji"].toString().toStdString(),
           .english = json["title"]["english"].toString().toStdString(),
@@ -124,13 +123,18 @@ std::optional<Anime> parseMedia(const QJsonValue& json) {
     }
   }
 
+  auto extras = std::make_shared<anime::Extras>(anime::Extras{
+      .image_url = json["coverImage"]["extraLarge"].toString().toStdString(),
+      .synopsis = json["description"].toString().toStdString(),
+  });
   if (json["trailer"]["site"] == "youtube") {
-    item.trailer_id = json["trailer"]["id"].toString().toStdString();
+    extras->trailer_id = json["trailer"]["id"].toString().toStdString();
   }
+  item.extras = std::move(extras);
 
   for (const auto value : json["genres"].toArray()) {
     auto genre = value.toString().toStdString();
-    if (!genre.empty()) item.genres.emplace_back(genre);
+    if (!genre.empty()) item.genres.emplace_back(anime::symbols.intern(genre));
   }
 
   for (const auto value : json["synonyms"].toArray()) {
@@ -142,15 +146,16 @@ std::optional<Anime> parseMedia(const QJsonValue& json) {
     const auto tag = value.toObject();
     if (tag["isMediaSpoiler"].toBool()) continue;
     auto name = tag["name"].toString().toStdString();
-    if (!name.empty()) item.tags.emplace_back(name);
+    if (!name.empty()) item.tags.emplace_back(anime::symbols.intern(name));
   }
 
   for (const auto value : json["studios"]["edges"].toArray()) {
     const auto edge = value.toObject();
+    const auto name = anime::symbols.intern(edge["node"]["name"].toString().toStdString());
     if (edge["isMain"].toBool()) {
-      item.studios.push_back(edge["node"]["name"].toString().toStdString());
+      item.studios.push_back(name);
     } else {
-      item.producers.push_back(edge["node"]["name"].toString().toStdString());
+      item.producers.push_back(name);
     }
   }
 
@@ -159,4 +164,20 @@ std::optional<Anime> parseMedia(const QJsonValue& json) {
   return item;
 }
 
+std::vector<anime::Uid> parseMediaUids(const QJsonValue& json) {
+  const int id = json["id"].toInt();
+
+  if (!id) return {};
+
+  std::vector<anime::Uid> uids{
+      {.service = ServiceId::AniList, .service_id = id, .anime_id = id},
+  };
+
+  if (const int malId = json["idMal"].toInt()) {
+    uids.push_back({.service = ServiceId::MyAnimeList, .service_id = malId, .anime_id = id});
+  }
+
+  return uids;
+}
+
 }  // namespace sync::anilist
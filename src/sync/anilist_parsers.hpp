@@ -21,6 +21,7 @@
 #include <QString>
 #include <optional>
 #include <string>
+#include <vector>
 
 class QJsonValue;
 
@@ -32,6 +33,7 @@ namespace anime {
 enum class Status;
 enum class Type;
 struct Details;
+struct Uid;
 }  // namespace anime
 
 namespace anime::list {
@@ -48,4 +50,7 @@ anime::Type parseType(const QString& value);
 
 std::optional<anime::Details> parseMedia(const QJsonValue& json);
 
+// Items are stored with their AniList ids, so these map them to themselves and to MyAnimeList
+std::vector<anime::Uid> parseMediaUids(const QJsonValue& json);
+
 }  // namespace sync::anilist
@@ -31,6 +31,7 @@
 #include "taiga/path.hpp"
 #include "taiga/settings.hpp"
 #include "taiga/version.hpp"
+#include "track/recognition_cache.hpp"
 
 namespace taiga {
 
@@ -47,6 +48,8 @@ Application::~Application() {
   if (window_) {
     window_->hide();
   }
+
+  anime::db.close();
 }
 
 int Application::run() {
@@ -70,6 +73,12 @@ int Application::run() {
   }
 
   taiga::settings.init();
+
+  // The recognition cache is built in the background as soon as the database is ready, rather
+  // than when the first file is identified
+  connect(&anime::db, &anime::Database::ready, this,
+          []() { track::recognition::cache()->initAsync(); });
+
   anime::db.init();
 
   gui::theme.initStyle();
@@ -24,10 +24,18 @@
 
 #include "taiga/config.h"
 
+namespace {
+
+std::string data_path_override;
+
+}  // namespace
+
 namespace taiga {
 
 // Returns current path in portable mode, AppData location otherwise
 std::string get_data_path() {
+  if (!data_path_override.empty()) return data_path_override;
+
 #ifdef TAIGA_PORTABLE
   return std::format("{}/data", QCoreApplication::applicationDirPath().toStdString());
 #else
@@ -36,4 +44,8 @@ std::string get_data_path() {
 #endif
 }
 
+void set_data_path(const std::string& path) {
+  data_path_override = path;
+}
+
 }  // namespace taiga
@@ -24,4 +24,8 @@ namespace taiga {
 
 std::string get_data_path();
 
+// Overrides the path that is returned by `get_data_path()`, for tools such as benchmarks that
+// must not touch the user's data
+void set_data_path(const std::string& path);
+
 }  // namespace taiga
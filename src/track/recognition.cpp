@@ -22,7 +22,9 @@
 #include <QFileInfo>
 #include <algorithm>
 #include <anitomy.hpp>
-#include <ranges>
+#include <functional>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "media/anime.hpp"
@@ -59,23 +61,72 @@ int identify(Episode& episode) {
   cache()->init();
 
   const auto title = episode.element(anitomy::ElementKind::Title);
-  const auto normalizedTitle = normalize(title);
 
-  std::vector<Cache::Data::Match> matches;
+  thread_local std::string normalizedTitle;
+  normalize(title, normalizedTitle);
 
-  if (const auto data = cache()->find(normalizedTitle)) {
-    matches.append_range(data->matches | std::views::values | std::ranges::to<std::vector>());
+  // Matches are kept sorted in the cache, so they can be tried without copying them
+  for (const auto& match : cache()->find(normalizedTitle)) {
+    if (isValidMatch(match.id, episode)) return match.id;
   }
 
-  std::ranges::sort(matches, {}, &Cache::Data::Match::score);
+  // Similar titles are only accepted with a clear winner, which requires the year or the type to
+  // agree unless the titles are the same. Same thresholds as v1, which are applied after the bonus.
+  constexpr float kMinScore = 0.3f;
+  constexpr size_t kMaxMatches = 20;
 
-  for (const auto& match : matches) {
-    if (isValidMatch(match.id, episode)) return match.id;
+  auto similar = cache()->findSimilar(normalizedTitle);
+
+  for (auto& match : similar) {
+    match.score += bonusScore(match.id, episode);
+  }
+
+  std::erase_if(similar, [](const Cache::Data::Match& match) { return match.score < kMinScore; });
+  std::ranges::stable_sort(similar, std::ranges::greater{}, &Cache::Data::Match::score);
+  if (similar.size() > kMaxMatches) similar.resize(kMaxMatches);
+
+  if (!similar.empty()) {
+    const float first = similar[0].score;
+    const float second = similar.size() > 1 ? similar[1].score : 0.0f;
+    if (first >= 1.0f && first != second && isValidMatch(similar[0].id, episode)) {
+      return similar[0].id;
+    }
   }
 
   return anime::kUnknownId;
 }
 
+float bonusScore(const int id, const Episode& episode) {
+  static const std::unordered_map<std::string, anime::Type> types{
+      // clang-format off
+      {"movie",   anime::Type::Movie},
+      {"oad",     anime::Type::Ova},
+      {"ona",     anime::Type::Ona},
+      {"ova",     anime::Type::Ova},
+      {"sp",      anime::Type::Special},
+      {"special", anime::Type::Special},
+      {"tv",      anime::Type::Tv},
+      // clang-format on
+  };
+
+  const auto item = anime::db.item(id);
+
+  if (!item) return 0.0f;
+
+  float score = 0.0f;
+
+  const auto year = QString::fromStdString(episode.element(anitomy::ElementKind::Year)).toInt();
+  if (year && year == static_cast<int>(item->date_started.year())) score += 0.1f;
+
+  const auto type = QString::fromStdString(episode.element(anitomy::ElementKind::Type)).toLower();
+  if (const auto it = types.find(type.toStdString());
+      it != types.end() && it->second == item->type) {
+    score += 0.1f;
+  }
+
+  return score;
+}
+
 bool isValidMatch(const int id, const Episode& episode) {
   const auto item = anime::db.item(id);
 
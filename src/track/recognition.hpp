@@ -33,6 +33,9 @@ Episode parseFileInfo(const QFileInfo& info, const anitomy::Options options = {}
 
 int identify(Episode& episode);
 
+// Returns what the year and the type of the episode add to the score of a similar title
+float bonusScore(const int id, const Episode& episode);
+
 bool isValidMatch(const int id, const Episode& episode);
 
 }  // namespace track::recognition
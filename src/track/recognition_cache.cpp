@@ -18,9 +18,19 @@
 
 #include "recognition_cache.hpp"
 
+#include <QList>
+#include <QObject>
+#include <algorithm>
 #include <format>
+#include <functional>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
 
+#include "media/anime.hpp"
 #include "media/anime_db.hpp"
+#include "media/anime_snapshot.hpp"
 #include "track/recognition.hpp"
 #include "track/recognition_normalize.hpp"
 
@@ -30,29 +40,163 @@ bool Cache::empty() const {
   return titles_.empty();
 }
 
-const std::optional<Cache::Data> Cache::find(const std::string& title) const {
-  const auto it = titles_.find(title);
-  if (it == titles_.end()) return std::nullopt;
-  return it->second;
+std::span<const Cache::Data::Match> Cache::find(std::string_view title) const {
+  const auto data = titles_.find(title);
+  if (!data) return {};
+  return data->matches;
+}
+
+std::vector<Cache::Data::Match> Cache::findSimilar(const std::string& title) const {
+  // Same threshold as v1
+  constexpr double kMinTrigramScore = 0.1;
+
+  const auto query = toCodePoints(title);
+  const auto queryTrigrams = trigrams(query);
+
+  if (queryTrigrams.empty()) return {};
+
+  // Shared trigrams are counted in a dense array that is reused between calls, so that only the
+  // titles that were touched need to be reset
+  thread_local std::vector<uint16_t> counts;
+  thread_local std::vector<uint32_t> touched;
+  counts.resize(fuzzyTitles_.size());
+  touched.clear();
+
+  for (const auto trigram : queryTrigrams) {
+    const auto it = postings_.find(trigram);
+    if (it == postings_.end()) continue;
+    for (const auto index : it->second) {
+      if (!counts[index]++) touched.push_back(index);
+    }
+  }
+
+  std::unordered_map<int, double> trigramScores;
+
+  for (const auto index : touched) {
+    const auto& candidate = fuzzyTitles_[index];
+    const auto shared = static_cast<double>(std::exchange(counts[index], 0));
+    const double trigramScore =
+        shared / static_cast<double>(std::max(queryTrigrams.size(), candidate.trigramCount));
+    if (trigramScore <= kMinTrigramScore) continue;
+    auto& score = trigramScores[candidate.id];
+    score = std::max(score, trigramScore);
+  }
+
+  // Other measures are taken over every title of a candidate, including those that didn't share
+  // enough trigrams with the query
+  std::vector<Data::Match> matches;
+  matches.reserve(trigramScores.size());
+
+  for (const auto [id, trigramScore] : trigramScores) {
+    TitleScores scores{.trigram = trigramScore};
+    for (const auto index : keys_.at(id).fuzzyTitles) {
+      updateTitleScores(scores, fuzzyTitles_[index].text, query);
+    }
+    matches.emplace_back(id, static_cast<float>(blendTitleScores(scores)));
+  }
+
+  std::ranges::sort(matches, std::ranges::greater{}, &Data::Match::score);
+
+  return matches;
 }
 
 void Cache::clear() {
-  return titles_.clear();
+  QObject::disconnect(itemUpdated_);
+  QObject::disconnect(itemsUpdated_);
+  initialized_ = false;
+
+  ++generation_;
+  building_ = {};  // waits for the build in the background to finish
+  pendingIds_.clear();
+
+  titles_.clear();
+  keys_.clear();
+  fuzzyTitles_.clear();
+  freeTitles_.clear();
+  postings_.clear();
 }
 
 void Cache::init() {
-  if (!empty()) return;
+  if (initialized_) return;
 
-  for (const auto& item : anime::db.items()) {
-    add(item);
+  initAsync();
+  adoptBuilt();
+}
+
+void Cache::adoptBuilt() {
+  if (initialized_ || !building_.valid()) return;
+
+  const auto built = building_.get();
+  titles_ = std::move(built->titles_);
+  keys_ = std::move(built->keys_);
+  fuzzyTitles_ = std::move(built->fuzzyTitles_);
+  freeTitles_ = std::move(built->freeTitles_);
+  postings_ = std::move(built->postings_);
+
+  initialized_ = true;
+
+  for (const int id : std::exchange(pendingIds_, {})) {
+    update(id);
   }
 }
 
+void Cache::initAsync() {
+  // Building the cache from a partially loaded database would leave it incomplete
+  if (initialized_ || building_.valid() || !anime::db.isReady()) return;
+
+  // Changes are watched before the snapshot is taken, so that none of them are missed
+  itemUpdated_ = QObject::connect(&anime::db, &anime::Database::itemUpdated, &anime::db,
+                                  [this](const int id) { update(id); });
+  itemsUpdated_ = QObject::connect(&anime::db, &anime::Database::itemsUpdated, &anime::db,
+                                   [this](const QList<int>& ids) {
+                                     for (const int id : ids) update(id);
+                                   });
+
+  // The built cache is adopted on the main thread as soon as it's ready, so that changes to the
+  // database are not held back until the first call to `init()`
+  building_ = std::async(
+      std::launch::async,
+      [this, generation = generation_, snapshot = anime::db.snapshot()]() {
+        auto cache = build(snapshot);
+        QMetaObject::invokeMethod(
+            &anime::db,
+            [this, generation]() {
+              if (generation == generation_) adoptBuilt();
+            },
+            Qt::QueuedConnection);
+        return cache;
+      });
+}
+
 void Cache::add(const anime::Details& item) {
-  const auto add = [this, &item](const std::string& title, const float weight = 1.0f) {
-    const auto normalized = normalize(title);
+  auto titles = normalizeTitles(item);
+  add(item.id, titles);
+}
+
+void Cache::add(const int id, std::vector<NormalizedTitle>& titles) {
+  auto& keys = keys_[id];
+
+  for (auto& title : titles) {
+    auto& matches = titles_[title.text].matches;
+    if (std::ranges::contains(matches, id, &Data::Match::id)) continue;
+    matches.insert(std::ranges::upper_bound(matches, title.weight, {}, &Data::Match::score),
+                   Data::Match{id, title.weight});
+    keys.fuzzyTitles.push_back(addTitle(title, id));
+    keys.titles.push_back(std::move(title.text));
+  }
+}
+
+std::vector<Cache::NormalizedTitle> Cache::normalizeTitles(const anime::Details& item) {
+  std::vector<NormalizedTitle> titles;
+  std::string normalized;
+
+  const auto add = [&titles, &normalized](const std::string& title, const float weight = 1.0f) {
+    normalize(title, normalized);
     if (normalized.empty()) return;
-    titles_[normalized].matches.emplace(item.id, Data::Match{item.id, weight});
+    if (std::ranges::contains(titles, normalized, &NormalizedTitle::text)) return;
+    auto codePoints = toCodePoints(normalized);
+    auto titleTrigrams = trigrams(codePoints);
+    titles.emplace_back(normalized, std::move(codePoints), std::move(titleTrigrams), weight);
   };
 
   // @TODO: Add user-defined titles with higher weight
@@ -74,17 +218,126 @@ void Cache::add(const anime::Details& item) {
   for (const auto& synonym : item.titles.synonyms) {
     add(synonym, 0.5f);
   }
+
+  return titles;
+}
+
+std::unique_ptr<Cache> Cache::build(const std::shared_ptr<const anime::Snapshot> snapshot) {
+  // Shards are kept large enough to be worth a thread of their own
+  constexpr size_t kMinShardSize = 1000;
+
+  std::vector<const anime::Details*> items;
+  for (const auto& item : snapshot->items()) {
+    items.push_back(&item);
+  }
+
+  const size_t shardCount = std::clamp<size_t>(items.size() / kMinShardSize, 1,
+                                               std::max(1u, std::thread::hardware_concurrency()));
+  const size_t shardSize = (items.size() + shardCount - 1) / shardCount;
+
+  using Shard = std::vector<std::pair<int, std::vector<NormalizedTitle>>>;
+
+  const auto normalizeShard = [](const std::span<const anime::Details* const> items) {
+    Shard shard;
+    shard.reserve(items.size());
+    for (const auto item : items) {
+      shard.emplace_back(item->id, normalizeTitles(*item));
+    }
+    return shard;
+  };
+
+  // Titles are normalized in parallel, which is where most of the time goes, and then added to the
+  // cache one shard at a time while the following shards are still being normalized
+  std::vector<std::future<Shard>> shards;
+  for (size_t i = 0; i < items.size(); i += shardSize) {
+    const auto size = std::min(shardSize, items.size() - i);
+    shards.push_back(
+        std::async(std::launch::async, normalizeShard, std::span{items}.subspan(i, size)));
+  }
+
+  auto cache = std::make_unique<Cache>();
+
+  for (auto& shard : shards) {
+    for (auto& [id, titles] : shard.get()) {
+      cache->add(id, titles);
+    }
+  }
+
+  return cache;
 }
 
-void Cache::remove(const anime::Details& item) {
-  for (auto& [_, data] : titles_) {
-    data.matches.erase(item.id);
+void Cache::remove(const int id) {
+  const auto it = keys_.find(id);
+  if (it == keys_.end()) return;
+
+  for (const auto& title : it->second.titles) {
+    const auto data = titles_.find(title);
+    if (!data) continue;
+    std::erase_if(data->matches, [id](const Data::Match& match) { return match.id == id; });
+    if (data->matches.empty()) titles_.erase(title);
+  }
+
+  for (const auto index : it->second.fuzzyTitles) {
+    removeTitle(index);
   }
+
+  keys_.erase(it);
 }
 
 void Cache::update(const anime::Details& item) {
-  remove(item);
+  remove(item.id);
   add(item);
 }
 
+void Cache::update(const int id) {
+  if (!initialized_) {
+    pendingIds_.insert(id);
+    return;
+  }
+
+  if (const auto item = anime::db.item(id)) {
+    update(*item);
+  } else {
+    remove(id);
+  }
+}
+
+uint32_t Cache::addTitle(NormalizedTitle& title, const int id) {
+  uint32_t index = 0;
+  if (!freeTitles_.empty()) {
+    index = freeTitles_.back();
+    freeTitles_.pop_back();
+  } else {
+    index = static_cast<uint32_t>(fuzzyTitles_.size());
+    fuzzyTitles_.emplace_back();
+  }
+
+  for (const auto trigram : title.trigrams) {
+    auto& indices = postings_[trigram];
+    indices.insert(std::ranges::upper_bound(indices, index), index);
+  }
+
+  fuzzyTitles_[index] = {std::move(title.codePoints), title.trigrams.size(), id};
+
+  return index;
+}
+
+void Cache::removeTitle(const uint32_t index) {
+  auto& title = fuzzyTitles_[index];
+
+  for (const auto trigram : trigrams(title.text)) {
+    const auto posting = postings_.find(trigram);
+    if (posting == postings_.end()) continue;
+    auto& indices = posting->second;
+    if (const auto it = std::ranges::lower_bound(indices, index);
+        it != indices.end() && *it == index) {
+      indices.erase(it);
+    }
+    if (indices.empty()) postings_.erase(posting);
+  }
+
+  title = {};
+  freeTitles_.push_back(index);
+}
+
 }  // namespace track::recognition
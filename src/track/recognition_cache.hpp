@@ -18,13 +18,23 @@
 
 #pragma once
 
-#include <optional>
-#include <set>
+#include <QMetaObject>
+#include <QSet>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
+
+#include "base/flat_string_map.hpp"
+#include "track/recognition_score.hpp"
 
 namespace anime {
 struct Details;
+class Snapshot;
 };
 
 namespace track::recognition {
@@ -37,21 +47,85 @@ public:
       float score;
     };
 
-    std::unordered_map<int, Match> matches;
+    // Sorted by score, with at most one match per item
+    std::vector<Match> matches;
   };
 
   bool empty() const;
-  const std::optional<Data> find(const std::string& title) const;
+
+  // Returns the matches of `title`, which must be normalized. The view is borrowed from the cache,
+  // and is only valid until the cache is changed.
+  std::span<const Data::Match> find(std::string_view title) const;
+
+  // Scores the items that have a title that shares enough trigrams with `title`, which must be
+  // normalized, and returns them best matches first. As in v1, each measure is the best result
+  // over all titles of the item, and the measures are blended afterwards. Scores are returned
+  // unfiltered, so that the caller can add its bonus before applying a threshold.
+  std::vector<Data::Match> findSimilar(const std::string& title) const;
 
   void clear();
+
+  // Builds the cache once the database is ready, and keeps it up to date with the changes to the
+  // database from then on. Waits for the cache to be built if it's being built in the background.
   void init();
 
+  // Starts building the cache in the background once the database is ready, and starts using it as
+  // soon as it's built, so that it doesn't have to be built on the first call to `init()`
+  void initAsync();
+
   void add(const anime::Details& item);
-  void remove(const anime::Details& item);
+  void remove(const int id);
   void update(const anime::Details& item);
 
 private:
-  std::unordered_map<std::string, Data> titles_;
+  struct Title {
+    std::u32string text;
+    size_t trigramCount = 0;
+    int id = 0;
+  };
+
+  // Keys that an item was added with, so that it can be removed without visiting every title
+  struct Keys {
+    std::vector<std::string> titles;
+    std::vector<uint32_t> fuzzyTitles;
+  };
+
+  // A title of an item after normalization, which can be prepared on any thread
+  struct NormalizedTitle {
+    std::string text;
+    std::u32string codePoints;
+    std::vector<Trigram> trigrams;
+    float weight = 1.0f;
+  };
+
+  static std::vector<NormalizedTitle> normalizeTitles(const anime::Details& item);
+  static std::unique_ptr<Cache> build(const std::shared_ptr<const anime::Snapshot> snapshot);
+
+  void add(const int id, std::vector<NormalizedTitle>& titles);
+  uint32_t addTitle(NormalizedTitle& title, const int id);
+  void removeTitle(const uint32_t index);
+  void update(const int id);
+  void adoptBuilt();
+
+  base::FlatStringMap<Data> titles_;
+  std::unordered_map<int, Keys> keys_;
+
+  // Inverted index from each trigram to the titles that contain it, in ascending order. Slots of
+  // removed titles are reused by the titles that are added next.
+  std::vector<Title> fuzzyTitles_;
+  std::vector<uint32_t> freeTitles_;
+  std::unordered_map<Trigram, std::vector<uint32_t>> postings_;
+
+  // Changes to the database that are made while the cache is being built in the background are
+  // applied once it's ready. Builds that were started before the cache was last cleared are
+  // ignored.
+  std::future<std::unique_ptr<Cache>> building_;
+  QSet<int> pendingIds_;
+  unsigned int generation_ = 0;
+
+  bool initialized_ = false;
+  QMetaObject::Connection itemUpdated_;
+  QMetaObject::Connection itemsUpdated_;
 };
 
 inline Cache* cache() {
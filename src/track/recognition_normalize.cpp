@@ -1,6 +1,6 @@
 /**
  * Taiga
- * Copyright (C) 2010-2025, Eren Okka
+ * Copyright (C) 2010-2024, Eren Okka
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,121 +20,304 @@
 
 #include <utf8proc.h>
 
-#include <QList>
-#include <QString>
-#include <cstdlib>
-#include <ranges>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <vector>
 
-#include "base/string.hpp"
+// Titles are normalized in three stages:
+//
+// 1. Roman numerals, a few characters and romanizations are replaced. Roman numerals are matched
+//    case-sensitively, which is why this happens before the case is folded.
+// 2. The text is normalized and case-folded by utf8proc.
+// 3. Ordinals, season numbers and a few other words are replaced, and whitespace and punctuation
+//    are removed.
+//
+// The result is the same as that of replacing one word at a time over the whole text, but the
+// first and third stages each read the text once, and look up each word in a hash table.
 
 namespace track::recognition {
 
-std::string normalize(std::string title) {
-  auto str = QString::fromStdString(title);
+namespace {
 
-  normalizeRomanNumbers(str);
-  transliterate(str);
+using Text = std::u32string;
 
-  normalizeUnicode(str);  // title is lower case after this point, due to UTF8PROC_CASEFOLD
+enum class Kind {
+  Word,
+  Ordinal,
+  Number,
+  Season,
+  Series,
+};
 
-  normalizeOrdinalNumbers(str);
-  normalizeSeasonNumbers(str);
+struct Word {
+  std::u32string_view before;
+  std::u32string_view after;
+  Kind kind = Kind::Word;
+  int number = 0;  // the season number that the word may be a part of
+};
 
-  replaceWholeWord(str, "&", "and");
-  replaceWholeWord(str, "the animation", "");
-  replaceWholeWord(str, "the", "");
-  replaceWholeWord(str, "episode", "");
-  replaceWholeWord(str, "oad", "ova");
-  replaceWholeWord(str, "oav", "ova");
-  replaceWholeWord(str, "specials", "sp");
-  replaceWholeWord(str, "special", "sp");
-  replaceWholeWord(str, "(tv)", "");
+// Words are found by hashing them into a table that is laid out at compile time, rather than by
+// comparing them with every word in turn
+template <size_t N>
+class WordTable final {
+public:
+  consteval explicit WordTable(const std::array<Word, N>& words) {
+    for (const auto& word : words) {
+      auto i = hash(word.before) & kMask;
+      while (!slots_[i].before.empty()) i = (i + 1) & kMask;
+      slots_[i] = word;
+      maxLength_ = std::max(maxLength_, word.before.size());
+    }
+  }
+
+  const Word* find(std::u32string_view word) const {
+    if (word.empty() || word.size() > maxLength_) return nullptr;
+    for (auto i = hash(word) & kMask; !slots_[i].before.empty(); i = (i + 1) & kMask) {
+      if (slots_[i].before == word) return &slots_[i];
+    }
+    return nullptr;
+  }
+
+private:
+  // At least half of the slots are empty, so that probes are short and always end
+  static constexpr size_t kSize = std::bit_ceil(N * 2);
+  static constexpr size_t kMask = kSize - 1;
+
+  // FNV-1a
+  static constexpr uint32_t hash(std::u32string_view word) {
+    uint32_t value = 2166136261u;
+    for (const auto c : word) {
+      value = (value ^ static_cast<uint32_t>(c)) * 16777619u;
+    }
+    return value;
+  }
+
+  std::array<Word, kSize> slots_{};
+  size_t maxLength_ = 0;
+};
+
+// We skip 1 and 10 to avoid matching "I" and "X", as they're unlikely to be used as Roman
+// numerals. Any number above "XIII" is rarely used in anime titles, so we don't need an actual
+// Roman-to-Arabic number conversion algorithm.
+constexpr WordTable kRomanNumbers{std::array<Word, 11>{{
+    // clang-format off
+    {U"II",    U"2"},
+    {U"III",   U"3"},
+    {U"IV",    U"4"},
+    {U"V",     U"5"},
+    {U"VI",    U"6"},
+    {U"VII",   U"7"},
+    {U"VIII",  U"8"},
+    {U"IX",    U"9"},
+    {U"XI",   U"11"},
+    {U"XII",  U"12"},
+    {U"XIII", U"13"},
+    // clang-format on
+}}};
+
+// Romanizations (Hepburn to Wapuro)
+constexpr WordTable kRomanizations{std::array<Word, 3>{{
+    {U"wa", U"ha"},
+    {U"e", U"he"},
+    {U"o", U"wo"},
+}}};
+
+// Words of the third stage, which are replaced in this order: ordinals, season numbers (e.g.
+// "2nd season", "season 2", "series 2" and "s2" become "2"), and then the other words.
+constexpr WordTable kWords{std::array<Word, 37>{{
+    // clang-format off
+    {U"first",   U"1st", Kind::Ordinal, 1},
+    {U"second",  U"2nd", Kind::Ordinal, 2},
+    {U"third",   U"3rd", Kind::Ordinal, 3},
+    {U"fourth",  U"4th", Kind::Ordinal, 4},
+    {U"fifth",   U"5th", Kind::Ordinal, 5},
+    {U"sixth",   U"6th", Kind::Ordinal, 6},
+    {U"seventh", U"7th", Kind::Ordinal},
+    {U"eighth",  U"8th", Kind::Ordinal},
+    {U"ninth",   U"9th", Kind::Ordinal},
+
+    {U"1st", U"1st", Kind::Ordinal, 1},
+    {U"2nd", U"2nd", Kind::Ordinal, 2},
+    {U"3rd", U"3rd", Kind::Ordinal, 3},
+    {U"4th", U"4th", Kind::Ordinal, 4},
+    {U"5th", U"5th", Kind::Ordinal, 5},
+    {U"6th", U"6th", Kind::Ordinal, 6},
+    {U"1",   U"1",   Kind::Number,  1},
+    {U"2",   U"2",   Kind::Number,  2},
+    {U"3",   U"3",   Kind::Number,  3},
+    {U"4",   U"4",   Kind::Number,  4},
+    {U"5",   U"5",   Kind::Number,  5},
+    {U"6",   U"6",   Kind::Number,  6},
+    {U"season", U"season", Kind::Season},
+    {U"series", U"series", Kind::Series},
+    {U"s1", U"1"},
+    {U"s2", U"2"},
+    {U"s3", U"3"},
+    {U"s4", U"4"},
+    {U"s5", U"5"},
+    {U"s6", U"6"},
+
+    {U"the",      U""},
+    {U"episode",  U""},
+    {U"oad",      U"ova"},
+    {U"oav",      U"ova"},
+    {U"specials", U"sp"},
+    {U"special",  U"sp"},
+    // clang-format on
+}}};
+
+// Unlike the words above, these begin or end with punctuation, or span more than one word
+constexpr std::u32string_view kAnimation = U" animation";  // after "the"
+constexpr std::u32string_view kTv = U"(tv)";                // removed last
+
+constexpr std::array<std::u32string_view, 6> kSeasonNumbers{U"1", U"2", U"3", U"4", U"5", U"6"};
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Characters are classified the same way as `QChar` does for the UTF-16 code units of a
+// `QString`, so characters outside the BMP don't belong to any of these classes.
 
-  str = str.simplified();
-  erasePunctuation(str);
+utf8proc_category_t category(const char32_t c) {
+  if (c > 0xFFFF) return UTF8PROC_CATEGORY_CS;
+  return utf8proc_category(static_cast<utf8proc_int32_t>(c));
+}
 
-  return str.toStdString();
+bool isSpace(const char32_t c) {
+  if (c == 0x20 || (c >= 0x09 && c <= 0x0D) || c == 0x85) return true;
+  const auto value = category(c);
+  return value >= UTF8PROC_CATEGORY_ZS && value <= UTF8PROC_CATEGORY_ZP;
 }
 
-/////////////////////////////////////////////////////////////////////////////////
+bool isPunct(const char32_t c) {
+  const auto value = category(c);
+  return value >= UTF8PROC_CATEGORY_PC && value <= UTF8PROC_CATEGORY_PO;
+}
 
-void erasePunctuation(QString& str) {
-  static constexpr auto is_removable = [&](const QChar& c) {
-    // Control codes, white-space and punctuation characters
-    if (c.unicode() <= 0xFF && !c.isLetterOrNumber()) return true;
-    // Unicode stars, hearts, notes, etc.
-    if (c.unicode() > 0x2000 && c.unicode() < 0x2767) return true;
-    // Valid character
-    return false;
-  };
+bool isLetterOrNumber(const char32_t c) {
+  const auto value = category(c);
+  return (value >= UTF8PROC_CATEGORY_LU && value <= UTF8PROC_CATEGORY_LO) ||
+         (value >= UTF8PROC_CATEGORY_ND && value <= UTF8PROC_CATEGORY_NO);
+}
 
-  str.removeIf(is_removable);
-}
-
-void normalizeOrdinalNumbers(QString& str) {
-  static const QList<QPair<const char*, const char*>> ordinals{
-      // clang-format off
-      {"first",   "1st"},
-      {"second",  "2nd"},
-      {"third",   "3rd"},
-      {"fourth",  "4th"},
-      {"fifth",   "5th"},
-      {"sixth",   "6th"},
-      {"seventh", "7th"},
-      {"eighth",  "8th"},
-      {"ninth",   "9th"},
-      // clang-format on
-  };
+bool isBoundary(const char32_t c) {
+  return isSpace(c) || isPunct(c);
+}
+
+bool isRemovable(const char32_t c) {
+  // White-space
+  if (isSpace(c)) return true;
+  // Control codes and punctuation characters
+  if (c <= 0xFF && !isLetterOrNumber(c)) return true;
+  // Unicode stars, hearts, notes, etc.
+  if (c > 0x2000 && c < 0x2767) return true;
+  // Valid character
+  return false;
+}
+
+void appendUtf8(std::string& output, const char32_t c) {
+  std::array<utf8proc_uint8_t, 4> buffer;
+  const auto length = utf8proc_encode_char(static_cast<utf8proc_int32_t>(c), buffer.data());
+  output.append(reinterpret_cast<const char*>(buffer.data()), length);
+}
+
+template <typename Output>
+void transliterate(const char32_t c, Output output) {
+  // clang-format off
+  switch (c) {
+    // Character equivalencies that are not included in UTF8PROC_LUMP
+    case U'@': output(U'a'); break;  // e.g. "iDOLM@STER" (doesn't make a difference for "GJ-bu@" or "Sasami-san@Ganbaranai")
+    case U'×': output(U'x'); break;  // multiplication sign (e.g. "Tasogare Otome x Amnesia")
+    case U'꞉': output(U':'); break;  // modifier letter colon (e.g. "Nisekoi:")
+
+    // A few common always-equivalent romanizations
+    case U'Ō': output(U'o'); output(U'u'); break;  // latin capital letter o with macron
+    case U'ō': output(U'o'); output(U'u'); break;  // latin small letter o with macron
+    case U'ū': output(U'u'); output(U'u'); break;  // latin small letter u with macron
 
-  for (auto [before, after] : ordinals) {
-    replaceWholeWord(str, before, after);
+    default: output(c); break;
   }
+  // clang-format on
 }
 
-void normalizeRomanNumbers(QString& str) {
-  // We skip 1 and 10 to avoid matching "I" and "X", as they're unlikely to be used as Roman
-  // numerals. Any number above "XIII" is rarely used in anime titles, so we don't need an actual
-  // Roman-to-Arabic number conversion algorithm.
-  static const QList<QPair<const char*, const char*>> numerals{
-      // clang-format off
-      {"II",    "2"},
-      {"III",   "3"},
-      {"IV",    "4"},
-      {"V",     "5"},
-      {"VI",    "6"},
-      {"VII",   "7"},
-      {"VIII",  "8"},
-      {"IX",    "9"},
-      {"XI",   "11"},
-      {"XII",  "12"},
-      {"XIII", "13"},
-      // clang-format on
-  };
+template <typename Output>
+void forEachCodePoint(std::string_view input, Output output) {
+  auto data = reinterpret_cast<const utf8proc_uint8_t*>(input.data());
+  auto size = static_cast<utf8proc_ssize_t>(input.size());
 
-  for (auto [before, after] : numerals) {
-    replaceWholeWord(str, before, after);
+  while (size > 0) {
+    utf8proc_int32_t c = 0;
+    auto length = utf8proc_iterate(data, size, &c);
+    if (length <= 0) {
+      c = 0xFFFD;  // invalid sequences are replaced, as `QString::fromStdString()` does
+      length = 1;
+    }
+    output(static_cast<char32_t>(c));
+    data += length;
+    size -= length;
   }
 }
 
-void normalizeSeasonNumbers(QString& str) {
-  // This works considerably faster than regular expressions.
-  static const QList<QPair<const char*, QList<const char*>>> values{
-      {"1", {"1st season", "season 1", "series 1", "s1"}},
-      {"2", {"2nd season", "season 2", "series 2", "s2"}},
-      {"3", {"3rd season", "season 3", "series 3", "s3"}},
-      {"4", {"4th season", "season 4", "series 4", "s4"}},
-      {"5", {"5th season", "season 5", "series 5", "s5"}},
-      {"6", {"6th season", "season 6", "series 6", "s6"}},
+void decode(std::string_view input, Text& output) {
+  output.clear();
+  forEachCodePoint(input, [&output](const char32_t c) { output.push_back(c); });
+}
+
+// First stage: Roman numerals are matched against the words of the original text, and
+// romanizations against the words of the text after its characters have been transliterated.
+// Characters are transliterated as soon as the word that they belong to is known not to be a
+// Roman numeral, so that both are found while the text is read.
+void replaceRomanizations(std::string_view input, Text& word, Text& transliterated,
+                          std::string& output) {
+  word.clear();
+  transliterated.clear();
+  output.clear();
+
+  const auto flushTransliterated = [&transliterated, &output]() {
+    std::u32string_view text = transliterated;
+    if (const auto romanization = kRomanizations.find(text)) text = romanization->after;
+    for (const auto c : text) appendUtf8(output, c);
+    transliterated.clear();
   };
 
-  for (auto [after, list] : values) {
-    for (auto before : list) {
-      replaceWholeWord(str, before, after);
+  // Transliteration may turn boundaries into letters and the other way around, so romanizations
+  // are matched against words of their own
+  const auto putTransliterated = [&transliterated, &output,
+                                  &flushTransliterated](const char32_t c) {
+    if (!isBoundary(c)) {
+      transliterated.push_back(c);
+      return;
     }
-  }
+    flushTransliterated();
+    appendUtf8(output, c);
+  };
+
+  const auto flushWord = [&word, &putTransliterated]() {
+    if (const auto number = kRomanNumbers.find(word)) {
+      for (const auto c : number->after) putTransliterated(c);
+    } else {
+      for (const auto c : word) transliterate(c, putTransliterated);
+    }
+    word.clear();
+  };
+
+  forEachCodePoint(input, [&word, &flushWord, &putTransliterated](const char32_t c) {
+    if (!isBoundary(c)) {
+      word.push_back(c);
+      return;
+    }
+    flushWord();
+    transliterate(c, putTransliterated);
+  });
+
+  flushWord();
+  flushTransliterated();
 }
 
-void normalizeUnicode(QString& str) {
+// Second stage
+void normalizeUnicode(const std::string& input, std::vector<utf8proc_int32_t>& buffer,
+                      Text& output) {
   constexpr int options =
       // NFKC normalization according to Unicode Standard Annex #15
       UTF8PROC_COMPAT | UTF8PROC_COMPOSE | UTF8PROC_STABLE |
@@ -146,42 +329,205 @@ void normalizeUnicode(QString& str) {
       // Perform unicode case folding for case-insensitive comparison
       UTF8PROC_CASEFOLD;
 
-  char* buffer = nullptr;
+  const auto data = reinterpret_cast<const utf8proc_uint8_t*>(input.data());
+  const auto size = static_cast<utf8proc_ssize_t>(input.size());
 
-  const auto length = utf8proc_map(reinterpret_cast<const utf8proc_uint8_t*>(str.data()),
-                                   str.length(), reinterpret_cast<utf8proc_uint8_t**>(&buffer),
-                                   static_cast<utf8proc_option_t>(options));
+  const auto decompose = [&]() {
+    return utf8proc_decompose(data, size, buffer.data(),
+                              static_cast<utf8proc_ssize_t>(buffer.size()),
+                              static_cast<utf8proc_option_t>(options));
+  };
 
+  // The buffer keeps its size between calls, and only grows when it's too small
+  auto length = decompose();
+  if (length > static_cast<utf8proc_ssize_t>(buffer.size())) {
+    buffer.resize(length);
+    length = decompose();
+  }
   if (length >= 0) {
-    str = QString::fromLatin1(buffer, length);
+    length = utf8proc_normalize_utf32(buffer.data(), length,
+                                      static_cast<utf8proc_option_t>(options));
+  }
+
+  // The text is left as it is if it can't be normalized
+  if (length < 0) {
+    decode(input, output);
+    return;
   }
 
-  std::free(buffer);
+  output.assign(buffer.begin(), buffer.begin() + length);
 }
 
-void transliterate(QString& str) {
-  for (qsizetype i = 0; i < str.size(); ++i) {
-    auto& c = str[i];
+// Replaces the season numbers in a run of words that are separated by single spaces. Each season
+// number is replaced in turn, and each form of it over the whole run, which allows one replacement
+// to complete another (e.g. "series 2nd season" becomes "series 2", which becomes "2") and an
+// earlier one to take the words of a later one (e.g. "2nd season 1" becomes "2nd 1").
+void replaceSeasonNumbers(std::vector<Word>& words) {
+  if (words.size() < 2) return;
 
-    // clang-format off
-    switch (c.unicode()) {
-      // Character equivalencies that are not included in UTF8PROC_LUMP
-      case u'@': c = u'a'; break;  // e.g. "iDOLM@STER" (doesn't make a difference for "GJ-bu@" or "Sasami-san@Ganbaranai")
-      case u'×': c = u'x'; break;  // multiplication sign (e.g. "Tasogare Otome x Amnesia")
-      case u'꞉': c = u':'; break;  // modifier letter colon (e.g. "Nisekoi:")
-
-      // A few common always-equivalent romanizations
-      case u'Ō': str.replace(i, 1, "ou"); break;  // latin capital letter o with macron
-      case u'ō': str.replace(i, 1, "ou"); break;  // latin small letter o with macron
-      case u'ū': str.replace(i, 1, "uu"); break;  // latin small letter u with macron
+  const auto isNumber = [](const Word& word, const int number) {
+    return word.kind == Kind::Number && word.number == number;
+  };
+
+  const std::array<bool (*)(const Word&, const Word&, const int), 3> forms{
+      // "2nd season"
+      [](const Word& a, const Word& b, const int number) {
+        return a.kind == Kind::Ordinal && a.number == number && b.kind == Kind::Season;
+      },
+      // "season 2"
+      [](const Word& a, const Word& b, const int number) {
+        return a.kind == Kind::Season && b.kind == Kind::Number && b.number == number;
+      },
+      // "series 2"
+      [](const Word& a, const Word& b, const int number) {
+        return a.kind == Kind::Series && b.kind == Kind::Number && b.number == number;
+      },
+  };
+
+  for (int number = 1; number <= static_cast<int>(kSeasonNumbers.size()); ++number) {
+    if (std::ranges::none_of(words, [&](const Word& word) { return word.number == number; })) {
+      continue;
     }
-    // clang-format on
+    for (const auto form : forms) {
+      for (size_t i = 0; i + 1 < words.size(); ++i) {
+        if (!form(words[i], words[i + 1], number)) continue;
+        const auto after = kSeasonNumbers[number - 1];
+        words[i] = {after, after, Kind::Number, number};
+        words.erase(words.begin() + i + 1);
+      }
+    }
+  }
+}
+
+// Removes "(tv)", whitespace and punctuation from the text, while it's still being written. "(tv)"
+// is only removed as a whole word, which requires looking a few characters ahead.
+class Eraser final {
+public:
+  Eraser(const Text& input, std::string& output) : input_{input}, output_{output} {
+    output_.clear();
+  }
+
+  void erase(const bool done) {
+    const size_t end = done ? input_.size() : input_.size() - std::min(input_.size(), kTv.size());
+
+    while (position_ < end) {
+      if (boundary_ && std::u32string_view{input_}.substr(position_).starts_with(kTv)) {
+        const size_t next = position_ + kTv.size();
+        if (next == input_.size() || isBoundary(input_[next])) {
+          position_ = next;
+          continue;
+        }
+      }
+      const auto c = input_[position_++];
+      boundary_ = isBoundary(c);
+      if (!isRemovable(c)) appendUtf8(output_, c);
+    }
+  }
+
+private:
+  const Text& input_;
+  std::string& output_;
+  size_t position_ = 0;
+
+  // Whether the text before the current position ends with a boundary, after "(tv)" has been
+  // removed from it
+  bool boundary_ = true;
+};
+
+// Third stage: words are read one at a time, and runs of words that may form season numbers are
+// read as a whole. "&" is only replaced as a whole word, and not right after another "&" that was
+// replaced, as "and" isn't a boundary.
+void replaceWords(std::u32string_view input, std::vector<Word>& seasonWords, Text& replaced,
+                  std::string& output) {
+  replaced.clear();
+  Eraser eraser{replaced, output};
+
+  const auto isSeasonWord = [](const Word* word) {
+    return word && word->kind != Kind::Word && (word->kind != Kind::Ordinal || word->number);
+  };
+
+  const auto wordEnd = [&input](size_t i) {
+    while (i < input.size() && !isBoundary(input[i])) ++i;
+    return i;
+  };
+
+  bool ampersand = false;
+
+  for (size_t i = 0; i < input.size(); eraser.erase(false)) {
+    if (isBoundary(input[i])) {
+      const auto c = input[i++];
+      const bool before = !ampersand && (i == 1 || isBoundary(input[i - 2]));
+      const bool after = i == input.size() || isBoundary(input[i]);
+      ampersand = c == U'&' && before && after;
+      if (ampersand) {
+        replaced.append(U"and");
+      } else {
+        replaced.push_back(c);
+      }
+      continue;
+    }
+
+    ampersand = false;
+
+    size_t end = wordEnd(i);
+    const auto text = input.substr(i, end - i);
+    const auto word = kWords.find(text);
+
+    if (isSeasonWord(word)) {
+      seasonWords.assign(1, *word);
+      while (end + 1 < input.size() && input[end] == U' ' && !isBoundary(input[end + 1])) {
+        const size_t next = wordEnd(end + 1);
+        const auto nextWord = kWords.find(input.substr(end + 1, next - end - 1));
+        if (!isSeasonWord(nextWord)) break;
+        seasonWords.push_back(*nextWord);
+        end = next;
+      }
+      replaceSeasonNumbers(seasonWords);
+      for (size_t j = 0; j < seasonWords.size(); ++j) {
+        if (j > 0) replaced.push_back(U' ');
+        replaced.append(seasonWords[j].after);
+      }
+    } else if (text == U"the" && input.substr(end).starts_with(kAnimation) &&
+               wordEnd(end + 1) == end + kAnimation.size()) {
+      end += kAnimation.size();
+    } else if (word) {
+      replaced.append(word->after);
+    } else {
+      replaced.append(text);
+    }
+
+    i = end;
   }
 
-  // Romanizations (Hepburn to Wapuro)
-  replaceWholeWord(str, "wa", "ha");
-  replaceWholeWord(str, "e", "he");
-  replaceWholeWord(str, "o", "wo");
+  eraser.erase(true);
+}
+
+}  // namespace
+
+std::string normalize(std::string_view title) {
+  std::string output;
+  normalize(title, output);
+  return output;
+}
+
+void normalize(std::string_view title, std::string& output) {
+  struct Buffers {
+    Text text;
+    Text word;
+    Text transliterated;
+    std::string romanized;
+    std::vector<utf8proc_int32_t> decomposed;
+    std::vector<Word> seasonWords;
+  };
+
+  thread_local Buffers buffers;
+  auto& [text, word, transliterated, romanized, decomposed, seasonWords] = buffers;
+
+  replaceRomanizations(title, word, transliterated, romanized);
+
+  normalizeUnicode(romanized, decomposed, text);  // lower case from this point on
+
+  replaceWords(text, seasonWords, transliterated, output);
 }
 
 }  // namespace track::recognition
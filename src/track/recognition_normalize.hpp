@@ -1,6 +1,6 @@
 /**
  * Taiga
- * Copyright (C) 2010-2025, Eren Okka
+ * Copyright (C) 2010-2024, Eren Okka
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -18,18 +18,18 @@
 
 #pragma once
 
-#include <QString>
 #include <string>
+#include <string_view>
 
 namespace track::recognition {
 
-std::string normalize(std::string title);
+// Normalizes a title for comparison: numbers, season names and a few romanizations are brought
+// into a common form, the text is case-folded and decomposed, and whitespace and punctuation are
+// removed.
+std::string normalize(std::string_view title);
 
-void erasePunctuation(QString& str);
-void normalizeOrdinalNumbers(QString& str);
-void normalizeRomanNumbers(QString& str);
-void normalizeSeasonNumbers(QString& str);
-void normalizeUnicode(QString& str);
-void transliterate(QString& str);
+// Writes the result into `output`, reusing its capacity. Scratch buffers are kept per thread, so
+// that this doesn't allocate once they have grown to fit the longest title.
+void normalize(std::string_view title, std::string& output);
 
 }  // namespace track::recognition
@@ -0,0 +1,223 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2024, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "recognition_score.hpp"
+
+#include <utf8proc.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+// Ported from v1, where these measures were used to score the titles of every item in the
+// database. Here they are only used on the candidates that share trigrams with the title.
+
+namespace track::recognition {
+
+std::u32string toCodePoints(std::string_view str) {
+  std::u32string output;
+  output.reserve(str.size());
+
+  auto data = reinterpret_cast<const utf8proc_uint8_t*>(str.data());
+  auto size = static_cast<utf8proc_ssize_t>(str.size());
+
+  while (size > 0) {
+    utf8proc_int32_t c = 0;
+    const auto length = utf8proc_iterate(data, size, &c);
+    if (length <= 0) break;
+    output.push_back(static_cast<char32_t>(c));
+    data += length;
+    size -= length;
+  }
+
+  return output;
+}
+
+std::vector<Trigram> trigrams(std::u32string_view str) {
+  static constexpr auto pack = [](std::u32string_view str) {
+    Trigram trigram = 0;
+    for (size_t i = 0; i < 3; ++i) {
+      trigram = (trigram << 21) | (i < str.size() ? (str[i] & 0x1FFFFF) : 0);
+    }
+    return trigram;
+  };
+
+  std::vector<Trigram> output;
+
+  if (str.empty()) return output;
+
+  if (str.size() <= 3) {
+    output.push_back(pack(str));
+    return output;
+  }
+
+  output.reserve(str.size() - 2);
+  for (size_t i = 0; i + 3 <= str.size(); ++i) {
+    output.push_back(pack(str.substr(i, 3)));
+  }
+
+  std::ranges::sort(output);
+  const auto [first, last] = std::ranges::unique(output);
+  output.erase(first, last);
+
+  return output;
+}
+
+double compareTrigrams(const std::vector<Trigram>& a, const std::vector<Trigram>& b) {
+  if (a.empty() || b.empty()) return 0.0;
+
+  size_t shared = 0;
+  for (auto i = a.begin(), j = b.begin(); i != a.end() && j != b.end();) {
+    if (*i < *j) {
+      ++i;
+    } else if (*j < *i) {
+      ++j;
+    } else {
+      ++shared, ++i, ++j;
+    }
+  }
+
+  return static_cast<double>(shared) / static_cast<double>(std::max(a.size(), b.size()));
+}
+
+size_t longestCommonSubsequenceLength(std::u32string_view a, std::u32string_view b) {
+  if (a.empty() || b.empty()) return 0;
+
+  // Only the previous row of the table is needed
+  std::vector<size_t> prev(b.size() + 1);
+  std::vector<size_t> row(b.size() + 1);
+
+  for (size_t i = 0; i < a.size(); ++i) {
+    for (size_t j = 0; j < b.size(); ++j) {
+      row[j + 1] = a[i] == b[j] ? prev[j] + 1 : std::max(row[j], prev[j + 1]);
+    }
+    std::swap(prev, row);
+  }
+
+  return prev.back();
+}
+
+// Based on Miguel Serrano's Jaro-Winkler distance implementation
+// Licensed under GNU GPLv3 - Copyright (C) 2011 Miguel Serrano
+double jaroWinklerDistance(std::u32string_view a, std::u32string_view b) {
+  const int len1 = static_cast<int>(a.size());
+  const int len2 = static_cast<int>(b.size());
+
+  if (!len1 || !len2) return 0.0;
+
+  std::vector<bool> flags1(len1);
+  std::vector<bool> flags2(len2);
+
+  // Matching characters
+  int m = 0;
+  const int range = std::max(0, std::max(len1, len2) / 2 - 1);
+  for (int i = 0; i < len2; ++i) {
+    for (int j = std::max(i - range, 0), l = std::min(i + range + 1, len1); j < l; ++j) {
+      if (b[i] == a[j] && !flags1[j]) {
+        flags1[j] = true;
+        flags2[i] = true;
+        ++m;
+        break;
+      }
+    }
+  }
+  if (!m) return 0.0;
+
+  // Transpositions
+  int t = 0;
+  for (int i = 0, k = 0; i < len2; ++i) {
+    if (!flags2[i]) continue;
+    int j = k;
+    while (j < len1 && !flags1[j]) ++j;
+    k = j + 1;
+    if (j < len1 && b[i] != a[j]) ++t;
+  }
+  t /= 2;
+
+  const double jaro = (static_cast<double>(m) / len1 + static_cast<double>(m) / len2 +
+                       static_cast<double>(m - t) / m) /
+                      3.0;
+
+  // Common prefix of up to four characters
+  int prefix = 0;
+  for (int i = 0; i < std::min({len1, len2, 4}); ++i) {
+    if (a[i] == b[i]) ++prefix;
+  }
+
+  constexpr double scalingFactor = 0.1;
+  return jaro + prefix * scalingFactor * (1.0 - jaro);
+}
+
+double levenshteinDistance(std::u32string_view a, std::u32string_view b) {
+  const size_t length = std::max(a.size(), b.size());
+  if (!length) return 1.0;
+
+  std::vector<size_t> prev(b.size() + 1);
+  std::vector<size_t> col(b.size() + 1);
+
+  for (size_t j = 0; j < prev.size(); ++j) {
+    prev[j] = j;
+  }
+
+  for (size_t i = 0; i < a.size(); ++i) {
+    col[0] = i + 1;
+    for (size_t j = 0; j < b.size(); ++j) {
+      col[j + 1] = std::min({col[j] + 1, prev[j + 1] + 1, prev[j] + (a[i] == b[j] ? 0 : 1)});
+    }
+    std::swap(prev, col);
+  }
+
+  return 1.0 - static_cast<double>(prev.back()) / static_cast<double>(length);
+}
+
+double customScore(std::u32string_view title, std::u32string_view str) {
+  const auto lengthMin = static_cast<double>(std::min(title.size(), str.size()));
+  const auto lengthMax = static_cast<double>(std::max(title.size(), str.size()));
+
+  if (!lengthMin) return 0.0;
+
+  const double lengthRatio = lengthMin / lengthMax;
+
+  if (title.starts_with(str) || str.starts_with(title)) return lengthRatio;
+
+  if (title.contains(str) || str.contains(title)) return lengthRatio * 0.9;
+
+  const auto lcs = static_cast<double>(longestCommonSubsequenceLength(title, str));
+  double score = lcs / lengthMax * 0.8;
+
+  const auto [it, _] = std::ranges::mismatch(title, str);
+  if (const auto prefix = std::distance(title.begin(), it); prefix > 0) {
+    score = std::max(score, prefix / lengthMin * 0.7);
+  }
+
+  return score;
+}
+
+void updateTitleScores(TitleScores& scores, std::u32string_view title, std::u32string_view query) {
+  scores.jaroWinkler = std::max(scores.jaroWinkler, jaroWinklerDistance(title, query));
+  scores.custom = std::max(scores.custom, customScore(title, query));
+  scores.levenshtein = std::max(scores.levenshtein, levenshteinDistance(title, query));
+}
+
+double blendTitleScores(const TitleScores& scores) {
+  return (1.0 * scores.jaroWinkler + 0.5 * std::pow(scores.custom, 0.66) +
+          0.3 * std::pow(scores.levenshtein, 0.8) + 0.2 * std::pow(scores.trigram, 0.8)) /
+         2.0;
+}
+
+}  // namespace track::recognition
@@ -0,0 +1,63 @@
+/**
+ * Taiga
+ * Copyright (C) 2010-2024, Eren Okka
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace track::recognition {
+
+// Three consecutive code points, packed into a single value so that they can be compared and
+// hashed cheaply
+using Trigram = uint64_t;
+
+std::u32string toCodePoints(std::string_view str);
+
+// Returns the distinct trigrams of `str` in ascending order. Strings shorter than three code
+// points have a single trigram that is padded with zeros.
+std::vector<Trigram> trigrams(std::u32string_view str);
+
+// Ratio of shared trigrams, relative to the larger of both sets
+double compareTrigrams(const std::vector<Trigram>& a, const std::vector<Trigram>& b);
+
+size_t longestCommonSubsequenceLength(std::u32string_view a, std::u32string_view b);
+double jaroWinklerDistance(std::u32string_view a, std::u32string_view b);
+double levenshteinDistance(std::u32string_view a, std::u32string_view b);
+
+// Rewards titles that share a prefix or contain each other
+double customScore(std::u32string_view title, std::u32string_view str);
+
+// Best result of each measure over the titles of an item, where the trigram score is the result
+// of `compareTrigrams()`
+struct TitleScores {
+  double jaroWinkler = 0.0;
+  double custom = 0.0;
+  double levenshtein = 0.0;
+  double trigram = 0.0;
+};
+
+// Raises each measure in `scores` to its result for `title`, other than the trigram score
+void updateTitleScores(TitleScores& scores, std::u32string_view title, std::u32string_view query);
+
+// Blends the measures into a single score for the item, where 1.0 is a perfect match
+double blendTitleScores(const TitleScores& scores);
+
+}  // namespace track::recognition